@@ -11,10 +11,15 @@ class VertexInputBuffer final : core::VertexInputBuffer
 {
 public:
     ~VertexInputBuffer() override;
-    void CreateFromMesh(const core::Mesh& mesh) override;
+    void CreateFromMesh(const core::Mesh& mesh, core::pb::VertexLayout vertexLayout = core::pb::FULL_VERTEX) override;
     void Bind() override;
     void Destroy() override;
+    /**
+     * @brief GetPositionQuantization is what the shaders use to decode the positions of a QUANTIZED_VERTEX mesh
+     */
+    [[nodiscard]] const core::PositionQuantization& GetPositionQuantization() const { return positionQuantization_; }
 private:
+    core::PositionQuantization positionQuantization_{};
     GLuint vao{};
     GLuint vbo{};
     GLuint ebo{};
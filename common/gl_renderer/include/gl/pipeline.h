@@ -55,6 +55,7 @@ public:
     void SetTexture(std::string_view uniformName, const gl::Texture& texture, GLenum textureUnit);
     void SetTexture(std::string_view uniformName, GLuint textureName, GLenum textureUnit);
     void SetCubemap(std::string_view uniformName, GLuint textureName, GLenum textureUnit);
+    [[nodiscard]] bool HasUniform(std::string_view uniformName) { return GetUniformLocation(uniformName) != -1; }
 
 
 private:
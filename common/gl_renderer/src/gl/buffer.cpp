@@ -8,6 +8,9 @@
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 
+#include <cstddef>
+#include <cstdint>
+
 #ifdef TRACY_ENABLE
 #include <tracy/TracyOpenGL.hpp>
 #endif
@@ -22,7 +25,31 @@ VertexInputBuffer::~VertexInputBuffer()
     }
 }
 
-void VertexInputBuffer::CreateFromMesh(const core::Mesh& mesh)
+namespace
+{
+struct GlAttributeType
+{
+    GLenum type;
+    GLboolean normalized;
+};
+
+GlAttributeType GetGlAttributeType(core::VertexAttributeType attributeType)
+{
+    switch (attributeType)
+    {
+    case core::VertexAttributeType::HALF_FLOAT:
+        return { GL_HALF_FLOAT, GL_FALSE };
+    case core::VertexAttributeType::SNORM16:
+        return { GL_SHORT, GL_TRUE };
+    case core::VertexAttributeType::SNORM8:
+        return { GL_BYTE, GL_TRUE };
+    default:
+        return { GL_FLOAT, GL_FALSE };
+    }
+}
+}
+
+void VertexInputBuffer::CreateFromMesh(const core::Mesh& mesh, core::pb::VertexLayout vertexLayout)
 {
 #ifdef TRACY_ENABLE
     TracyGpuNamedZone(loadBuffer, "Create Vertex Buffer", true);
@@ -35,22 +62,32 @@ void VertexInputBuffer::CreateFromMesh(const core::Mesh& mesh)
     glBindVertexArray(vao);
     // 2. copy our vertices array in a buffer for OpenGL to use
     glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, mesh.vertices.size() * sizeof(core::Vertex), mesh.vertices.data(), GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(core::Vertex), (void*)offsetof(core::Vertex, position));
-    glEnableVertexAttribArray(0);
-    //bind texture coords data
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(core::Vertex), (void*)offsetof(core::Vertex, texCoords));
-    glEnableVertexAttribArray(1);
-    // bind normals data
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(core::Vertex), (void*)offsetof(core::Vertex, normal));
-    glEnableVertexAttribArray(2);
-    // bind tangent data
-    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(core::Vertex), (void*)offsetof(core::Vertex, tangent));
-    glEnableVertexAttribArray(3);
-    // bind bitangent data
-    glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(core::Vertex), (void*)offsetof(core::Vertex, bitangent));
-    glEnableVertexAttribArray(4);
+    const auto& layoutInfo = core::GetVertexLayoutInfo(vertexLayout);
+    const auto vertexBufferSize = mesh.vertices.size() * layoutInfo.stride;
+    positionQuantization_ = {};
+    if (vertexLayout == core::pb::FULL_VERTEX || mesh.vertices.empty())
+    {
+        glBufferData(GL_ARRAY_BUFFER, vertexBufferSize, mesh.vertices.data(), GL_STATIC_DRAW);
+    }
+    else
+    {
+        // the compact vertices are encoded directly in the mapped buffer
+        glBufferData(GL_ARRAY_BUFFER, vertexBufferSize, nullptr, GL_STATIC_DRAW);
+        auto* vertexData = static_cast<std::byte*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, vertexBufferSize,
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+        positionQuantization_ = core::EncodeVertices(mesh.vertices, vertexLayout, { vertexData, vertexBufferSize });
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+
+    // position, texture coords, normal, tangent and bitangent, the compact layouts have the bitangent sign in the tangent
+    for (std::uint32_t i = 0; i < layoutInfo.attributeCount; i++)
+    {
+        const auto& attribute = layoutInfo.attributes[i];
+        const auto [type, normalized] = GetGlAttributeType(attribute.type);
+        glVertexAttribPointer(i, static_cast<GLint>(attribute.componentCount), type, normalized,
+            static_cast<GLsizei>(layoutInfo.stride), reinterpret_cast<void*>(static_cast<std::uintptr_t>(attribute.offset)));
+        glEnableVertexAttribArray(i);
+    }
     //bind EBO
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.indices.size()*sizeof(unsigned), mesh.indices.data(), GL_STATIC_DRAW);
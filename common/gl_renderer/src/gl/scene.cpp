@@ -9,6 +9,7 @@
 
 #include "renderer/pipeline.h"
 #include "renderer/material.h"
+#include "renderer/vertex_layout.h"
 
 #include <fmt/format.h>
 #include <string_view>
@@ -173,11 +174,14 @@ Scene::ImportStatus Scene::LoadMaterials(const PbRepeatField<core::pb::Material>
     Scene::ImportStatus Scene::LoadModels(const PbRepeatField<std::string>& models)
     {
         auto& modelManager = core::GetModelManager();
-        const auto modelsSize = models.size();
-        for (int i = 0; i < modelsSize; i++)
+        std::vector<core::Path> modelPaths;
+        modelPaths.reserve(models.size());
+        for (const auto& model : models)
         {
-            modelIndices_.push_back(modelManager.ImportModel(core::Path(models.Get(i))));
+            modelPaths.emplace_back(model);
         }
+        const auto modelIndices = modelManager.ImportModels(modelPaths);
+        modelIndices_.insert(modelIndices_.end(), modelIndices.begin(), modelIndices.end());
 
         return ImportStatus::SUCCESS;
     }
@@ -198,7 +202,7 @@ Scene::ImportStatus Scene::LoadMaterials(const PbRepeatField<core::pb::Material>
                     const glm::vec3 offset{ meshInfo.offset().x(), meshInfo.offset().y(), meshInfo.offset().z() };
                     const auto mesh = core::GenerateQuad(scale, offset);
                     vertexBuffers_.emplace_back();
-                    vertexBuffers_.back().CreateFromMesh(mesh);
+                    vertexBuffers_.back().CreateFromMesh(mesh, meshInfo.vertex_layout());
                     break;
                 }
                 case core::pb::Mesh_PrimitveType_CUBE:
@@ -208,7 +212,7 @@ Scene::ImportStatus Scene::LoadMaterials(const PbRepeatField<core::pb::Material>
 
                     const auto mesh = core::GenerateCube(scale, offset);
                     vertexBuffers_.emplace_back();
-                    vertexBuffers_.back().CreateFromMesh(mesh);
+                    vertexBuffers_.back().CreateFromMesh(mesh, meshInfo.vertex_layout());
                     break;
                 }
                 case core::pb::Mesh_PrimitveType_SPHERE:
@@ -218,7 +222,7 @@ Scene::ImportStatus Scene::LoadMaterials(const PbRepeatField<core::pb::Material>
 
                     const auto mesh = core::GenerateSphere(scale.x, offset);
                     vertexBuffers_.emplace_back();
-                    vertexBuffers_.back().CreateFromMesh(mesh);
+                    vertexBuffers_.back().CreateFromMesh(mesh, meshInfo.vertex_layout());
                     break;
                 }
                 case core::pb::Mesh_PrimitveType_NONE:
@@ -231,7 +235,7 @@ Scene::ImportStatus Scene::LoadMaterials(const PbRepeatField<core::pb::Material>
                 {
                     const auto& mesh = modelManager.GetModel(modelIndices_[meshInfo.model_index()]).GetMesh(meshInfo.mesh_name());
                     vertexBuffers_.emplace_back();
-                    vertexBuffers_.back().CreateFromMesh(mesh);
+                    vertexBuffers_.back().CreateFromMesh(mesh, meshInfo.vertex_layout());
                     break;
                 }
                 default:
@@ -510,8 +514,16 @@ Scene::ImportStatus Scene::LoadMaterials(const PbRepeatField<core::pb::Material>
             const auto meshIndex = command.GetMeshIndex();
             if (meshIndex >= 0)
             {
-                vertexBuffers_[meshIndex].Bind();
+                auto& vertexBuffer = vertexBuffers_[meshIndex];
+                vertexBuffer.Bind();
                 glCheckError();
+                // the quantization is the identity for the meshes that are not QUANTIZED_VERTEX
+                if (pipeline.HasUniform(core::POSITION_QUANTIZATION_SCALE))
+                {
+                    const auto& positionQuantization = vertexBuffer.GetPositionQuantization();
+                    pipeline.SetVec3(core::POSITION_QUANTIZATION_SCALE, positionQuantization.scale);
+                    pipeline.SetVec3(core::POSITION_QUANTIZATION_OFFSET, positionQuantization.offset);
+                }
             }
             else
             {
@@ -618,6 +630,13 @@ Scene::ImportStatus Scene::LoadMaterials(const PbRepeatField<core::pb::Material>
         {
             const auto& commandInfo = subpassInfo.commands(j);
             drawCommands_.emplace_back(commandInfo, i);
+            const auto meshIndex = commandInfo.mesh_index();
+            if (meshIndex >= 0 && scene_.meshes(meshIndex).vertex_layout() == core::pb::QUANTIZED_VERTEX &&
+                !pipelines_[materials_[commandInfo.material_index()].pipelineIndex].HasUniform(core::POSITION_QUANTIZATION_SCALE))
+            {
+                LogError(fmt::format("Draw command {} draws a quantized mesh without {} in its vertex shader",
+                    commandInfo.name(), core::POSITION_QUANTIZATION_SCALE));
+            }
         }
 
         for(int j = 0; j < subpassInfo.compute_commands_size(); j++)
@@ -1,4 +1,5 @@
 #include "gl/texture.h"
+#include "engine/engine.h"
 #include "engine/filesystem.h"
 #include "utils/log.h"
 
@@ -133,7 +134,28 @@ bool Texture::LoadTexture(const core::pb::Texture &textureInfo)
         TracyCZoneN(ctx2, "Decompress", true);
 #endif
         int channelInFile;
-        const auto* imageData = stbi_load_from_memory(file.data, file.size, &width, &height, &channelInFile, 0);
+        // the images decoded by a previous run are in the asset cache
+        auto& assetCache = core::GetAssetCache();
+        const auto cacheKey = core::MakeAssetCacheKey({ file.data, file.size }, "stb_image:flip:channels0");
+        const auto cachedImage = assetCache.Load(cacheKey);
+        core::DecodedImageHeader imageHeader{};
+        const unsigned char* imageData = nullptr;
+        unsigned char* decodedData = nullptr;
+        if (core::ReadDecodedImage(cachedImage, imageHeader, imageData))
+        {
+            width = imageHeader.width;
+            height = imageHeader.height;
+            channelInFile = imageHeader.channels;
+        }
+        else
+        {
+            decodedData = stbi_load_from_memory(file.data, file.size, &width, &height, &channelInFile, 0);
+            imageData = decodedData;
+            if (decodedData != nullptr)
+            {
+                core::StoreDecodedImage(assetCache, cacheKey, { width, height, channelInFile, 1 }, decodedData);
+            }
+        }
 #ifdef TRACY_ENABLE
         TracyCZoneEnd(ctx2);
 #endif
@@ -230,6 +252,7 @@ bool Texture::LoadTexture(const core::pb::Texture &textureInfo)
             return false;
         }
         glCheckError();
+        stbi_image_free(decodedData);
         if(textureInfo.generate_mipmaps())
         {
 #ifdef TRACY_ENABLE
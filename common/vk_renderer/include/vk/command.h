@@ -82,6 +82,8 @@ public:
 
     }
 
+    [[nodiscard]] bool HasUniform(std::string_view uniformName) const { return uniformMap_.contains(std::string(uniformName)); }
+
     void Create();
     void Bind();
     void Destroy();
@@ -3,6 +3,7 @@
 #include "vk/common.h"
 #include "renderer/mesh.h"
 #include "renderer/model.h"
+#include "renderer/vertex_layout.h"
 
 namespace vk
 {
@@ -13,8 +14,13 @@ struct VertexInputBuffer
     std::size_t verticesCount;
     Buffer indexBuffer;
     std::size_t indicesCount;
+    core::pb::VertexLayout vertexLayout = core::pb::FULL_VERTEX;
+    core::PositionQuantization positionQuantization{};
 };
 
-VertexInputBuffer CreateVertexBufferFromMesh(const core::Mesh& mesh);
+/**
+ * @brief CreateVertexBufferFromMesh uploads the mesh in the vertex layout, it must match the one of the pipelines drawing it
+ */
+VertexInputBuffer CreateVertexBufferFromMesh(const core::Mesh& mesh, core::pb::VertexLayout vertexLayout = core::pb::FULL_VERTEX);
 
 }
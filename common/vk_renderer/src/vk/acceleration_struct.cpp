@@ -13,6 +13,12 @@ bool BottomAccelerationStructure::Create(
 	auto& vertexBuffers = scene->GetVertexBuffers();
 
 	auto& vertexBuffer = vertexBuffers[accelerationStruct.mesh_index()];
+	// the quantized positions are in the mesh bounds, the acceleration structure needs the actual ones
+	if (vertexBuffer.vertexLayout == core::pb::QUANTIZED_VERTEX)
+	{
+		LogError("Could not create BLAS, quantized vertex meshes are not supported");
+		return false;
+	}
 
 	VkDeviceOrHostAddressConstKHR vertexBufferDeviceAddress{};
 	VkDeviceOrHostAddressConstKHR indexBufferDeviceAddress{};
@@ -34,7 +40,7 @@ bool BottomAccelerationStructure::Create(
 	accelerationStructureGeometry.geometry.triangles.vertexFormat = VK_FORMAT_R32G32B32_SFLOAT;
 	accelerationStructureGeometry.geometry.triangles.vertexData = vertexBufferDeviceAddress;
 	accelerationStructureGeometry.geometry.triangles.maxVertex = maxVertex;
-	accelerationStructureGeometry.geometry.triangles.vertexStride = sizeof(core::Vertex);
+	accelerationStructureGeometry.geometry.triangles.vertexStride = core::GetVertexLayoutInfo(vertexBuffer.vertexLayout).stride;
 	accelerationStructureGeometry.geometry.triangles.indexType = VK_INDEX_TYPE_UINT32;
 	accelerationStructureGeometry.geometry.triangles.indexData = indexBufferDeviceAddress;
 	accelerationStructureGeometry.geometry.triangles.transformData.deviceAddress = 0;
@@ -697,6 +697,25 @@ void DrawCommand::Create()
     const auto& sceneInfo = core::GetCurrentScene()->GetInfo();
     uniformManager_.pipelineIndex = sceneInfo.materials(uniformManager_.materialIndex).pipeline_index();
     uniformManager_.Create();
+
+    // the mesh of a draw command does not change, its quantization is the identity if it is not QUANTIZED_VERTEX
+    const auto meshIndex = GetMeshIndex();
+    if (meshIndex == -1)
+    {
+        return;
+    }
+    if (uniformManager_.HasUniform(core::POSITION_QUANTIZATION_SCALE) && uniformManager_.HasUniform(core::POSITION_QUANTIZATION_OFFSET))
+    {
+        const auto* scene = static_cast<Scene*>(core::GetCurrentScene());
+        const auto& positionQuantization = scene->GetVertexBuffers()[meshIndex].positionQuantization;
+        uniformManager_.SetUniform(core::POSITION_QUANTIZATION_SCALE, positionQuantization.scale);
+        uniformManager_.SetUniform(core::POSITION_QUANTIZATION_OFFSET, positionQuantization.offset);
+    }
+    else if (sceneInfo.meshes(meshIndex).vertex_layout() == core::pb::QUANTIZED_VERTEX)
+    {
+        LogError(fmt::format("Draw command {} draws a quantized mesh without {} in its vertex shader",
+            GetName(), core::POSITION_QUANTIZATION_SCALE));
+    }
 }
 
 void DrawCommand::PreDrawBind()
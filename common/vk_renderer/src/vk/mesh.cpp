@@ -6,17 +6,18 @@
 namespace vk
 {
 
-VertexInputBuffer CreateVertexBufferFromMesh(const core::Mesh& mesh)
+VertexInputBuffer CreateVertexBufferFromMesh(const core::Mesh& mesh, core::pb::VertexLayout vertexLayout)
 {
     auto& engine = GetEngine();
-    const auto bufferSize = mesh.vertices.size()*sizeof(core::Vertex);
+    const auto bufferSize = mesh.vertices.size()*core::GetVertexLayoutInfo(vertexLayout).stride;
     const Buffer stagingVertexBuffer = CreateBuffer(bufferSize,
                                                            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
                                                            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
                                                            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
     const auto& allocator = GetAllocator();
     void* data = stagingVertexBuffer.Map();
-    std::memcpy(data, mesh.vertices.data(), bufferSize);
+    // the vertices are encoded directly in the staging buffer
+    const auto positionQuantization = core::EncodeVertices(mesh.vertices, vertexLayout, { static_cast<std::byte*>(data), bufferSize });
     stagingVertexBuffer.Unmap();
     auto vertexFlag = VK_BUFFER_USAGE_TRANSFER_DST_BIT |
         VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
@@ -51,6 +52,6 @@ VertexInputBuffer CreateVertexBufferFromMesh(const core::Mesh& mesh)
     CopyBuffer(stagingIndexBuffer, indexBuffer, mesh.indices.size() * sizeof(unsigned));
     vmaDestroyBuffer(allocator, stagingIndexBuffer.buffer, stagingIndexBuffer.allocation);
 
-    return {vertexBuffer, mesh.vertices.size(), indexBuffer, mesh.indices.size()};
+    return {vertexBuffer, mesh.vertices.size(), indexBuffer, mesh.indices.size(), vertexLayout, positionQuantization};
 }
 } // namespace vk
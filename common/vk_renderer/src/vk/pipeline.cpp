@@ -3,10 +3,31 @@
 #include "vk/engine.h"
 #include "vk/scene.h"
 #include "vk/utils.h"
+#include "renderer/vertex_layout.h"
+
+#include <algorithm>
 
 namespace vk
 {
 
+namespace
+{
+VkFormat GetVertexAttributeFormat(const core::VertexAttributeFormat& attribute)
+{
+    switch (attribute.type)
+    {
+    case core::VertexAttributeType::HALF_FLOAT:
+        return attribute.componentCount == 2 ? VK_FORMAT_R16G16_SFLOAT : VK_FORMAT_R16G16B16A16_SFLOAT;
+    case core::VertexAttributeType::SNORM16:
+        return VK_FORMAT_R16G16B16A16_SNORM;
+    case core::VertexAttributeType::SNORM8:
+        return VK_FORMAT_R8G8B8A8_SNORM;
+    default:
+        return attribute.componentCount == 2 ? VK_FORMAT_R32G32_SFLOAT : VK_FORMAT_R32G32B32_SFLOAT;
+    }
+}
+}
+
 bool Pipeline::LoadRasterizePipeline(const core::pb::Pipeline& pipelinePb,
                                     Shader& vertexShader,
                                     Shader& fragmentShader,
@@ -51,48 +72,29 @@ bool Pipeline::LoadRasterizePipeline(const core::pb::Pipeline& pipelinePb,
             .pName = "main" });
     }
     
+    const auto& vertexLayoutInfo = core::GetVertexLayoutInfo(pipelinePb.vertex_layout());
     VkVertexInputBindingDescription vertexInputBindingDescription{};
     vertexInputBindingDescription.binding = 0;
     vertexInputBindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-    vertexInputBindingDescription.stride = sizeof(core::Vertex);
-
-
-    std::array<VkVertexInputAttributeDescription, 5> vertexAttributeDescriptors;
-    auto& positionAttribute = vertexAttributeDescriptors[0];
-    positionAttribute.format = VK_FORMAT_R32G32B32_SFLOAT;
-    positionAttribute.binding = 0;
-    positionAttribute.location = 0;
-    positionAttribute.offset = offsetof(core::Vertex, position);
-
-    auto& texCoordsAttribute = vertexAttributeDescriptors[1];
-    texCoordsAttribute.format = VK_FORMAT_R32G32_SFLOAT;
-    texCoordsAttribute.binding = 0;
-    texCoordsAttribute.location = 1;
-    texCoordsAttribute.offset = offsetof(core::Vertex, texCoords);
-
-    auto& normalAttribute = vertexAttributeDescriptors[2];
-    normalAttribute.format = VK_FORMAT_R32G32B32_SFLOAT;
-    normalAttribute.binding = 0;
-    normalAttribute.location = 2;
-    normalAttribute.offset = offsetof(core::Vertex, normal);
-
-    auto& tangentAttribute = vertexAttributeDescriptors[3];
-    tangentAttribute.format = VK_FORMAT_R32G32B32_SFLOAT;
-    tangentAttribute.binding = 0;
-    tangentAttribute.location = 3;
-    tangentAttribute.offset = offsetof(core::Vertex, tangent);
-
-    auto& bitangentAttribute = vertexAttributeDescriptors[4];
-    bitangentAttribute.format = VK_FORMAT_R32G32B32_SFLOAT;
-    bitangentAttribute.binding = 0;
-    bitangentAttribute.location = 4;
-    bitangentAttribute.offset = offsetof(core::Vertex, bitangent);
+    vertexInputBindingDescription.stride = vertexLayoutInfo.stride;
+
+    // position, texture coords, normal, tangent and bitangent, the compact layouts have the bitangent sign in the tangent
+    std::array<VkVertexInputAttributeDescription, core::MAX_VERTEX_ATTRIBUTES> vertexAttributeDescriptors{};
+    for (std::uint32_t i = 0; i < vertexLayoutInfo.attributeCount; i++)
+    {
+        const auto& attribute = vertexLayoutInfo.attributes[i];
+        auto& attributeDescription = vertexAttributeDescriptors[i];
+        attributeDescription.format = GetVertexAttributeFormat(attribute);
+        attributeDescription.binding = 0;
+        attributeDescription.location = i;
+        attributeDescription.offset = attribute.offset;
+    }
 
     VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
     vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
     vertexInputInfo.vertexBindingDescriptionCount = pipelinePb.in_vertex_attributes_size() == 0 ? 0:1;
     vertexInputInfo.pVertexBindingDescriptions = pipelinePb.in_vertex_attributes_size() == 0 ? VK_NULL_HANDLE : &vertexInputBindingDescription;
-    vertexInputInfo.vertexAttributeDescriptionCount = pipelinePb.in_vertex_attributes_size();
+    vertexInputInfo.vertexAttributeDescriptionCount = std::min<std::uint32_t>(pipelinePb.in_vertex_attributes_size(), vertexLayoutInfo.attributeCount);
     vertexInputInfo.pVertexAttributeDescriptions =  vertexAttributeDescriptors.data(); // Optional
 
     VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
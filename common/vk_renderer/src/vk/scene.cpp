@@ -458,11 +458,14 @@ Scene::ImportStatus Scene::LoadMaterials(const PbRepeatField<core::pb::Material>
 Scene::ImportStatus Scene::LoadModels(const PbRepeatField<std::string>& models)
 {
     auto& modelManager = core::GetModelManager();
-    const auto modelsSize = models.size();
-    for (int i = 0; i < modelsSize; i++)
+    std::vector<core::Path> modelPaths;
+    modelPaths.reserve(models.size());
+    for (const auto& model : models)
     {
-        modelIndices_.push_back(modelManager.ImportModel(core::Path(models.Get(i))));
+        modelPaths.emplace_back(model);
     }
+    const auto modelIndices = modelManager.ImportModels(modelPaths);
+    modelIndices_.insert(modelIndices_.end(), modelIndices.begin(), modelIndices.end());
 
     return ImportStatus::SUCCESS;
 }
@@ -484,7 +487,7 @@ Scene::ImportStatus Scene::LoadMeshes(const PbRepeatField<core::pb::Mesh>& meshe
             const auto mesh = core::GenerateQuad(scale, offset);
             vertexBuffers_.emplace_back();
             
-            vertexBuffers_.back() = CreateVertexBufferFromMesh(mesh);
+            vertexBuffers_.back() = CreateVertexBufferFromMesh(mesh, meshInfo.vertex_layout());
             break;
         }
         case core::pb::Mesh_PrimitveType_CUBE:
@@ -494,7 +497,7 @@ Scene::ImportStatus Scene::LoadMeshes(const PbRepeatField<core::pb::Mesh>& meshe
 
             const auto mesh = core::GenerateCube(scale, offset);
             vertexBuffers_.emplace_back();
-            vertexBuffers_.back() = CreateVertexBufferFromMesh(mesh);;
+            vertexBuffers_.back() = CreateVertexBufferFromMesh(mesh, meshInfo.vertex_layout());;
             break;
         }
         case core::pb::Mesh_PrimitveType_SPHERE:
@@ -504,7 +507,7 @@ Scene::ImportStatus Scene::LoadMeshes(const PbRepeatField<core::pb::Mesh>& meshe
 
             const auto mesh = core::GenerateSphere(scale.x, offset);
             vertexBuffers_.emplace_back();
-            vertexBuffers_.back() = CreateVertexBufferFromMesh(mesh);
+            vertexBuffers_.back() = CreateVertexBufferFromMesh(mesh, meshInfo.vertex_layout());
 
             break;
         }
@@ -517,7 +520,7 @@ Scene::ImportStatus Scene::LoadMeshes(const PbRepeatField<core::pb::Mesh>& meshe
         {
             const auto& mesh = modelManager.GetModel(modelIndices_[meshInfo.model_index()]).GetMesh(meshInfo.mesh_name());
             vertexBuffers_.emplace_back();
-            vertexBuffers_.back() = CreateVertexBufferFromMesh(mesh);
+            vertexBuffers_.back() = CreateVertexBufferFromMesh(mesh, meshInfo.vertex_layout());
             break;
         }
         default:
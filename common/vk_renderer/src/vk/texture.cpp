@@ -44,7 +44,29 @@ bool Texture::LoadTexture(const core::pb::Texture& textureInfo)
     const auto file = filesystem.LoadFile(path);
     constexpr int requiredChannels = 4;
     int channelInFile;
-    auto* imageData = stbi_load_from_memory(file.data, file.size, &width, &height, &channelInFile, requiredChannels);
+    // the images decoded by a previous run are in the asset cache
+    auto& assetCache = core::GetAssetCache();
+    const auto cacheKey = core::MakeAssetCacheKey({ file.data, file.size },
+        fmt::format("stb_image:flip:channels{}", requiredChannels));
+    const auto cachedImage = assetCache.Load(cacheKey);
+    core::DecodedImageHeader imageHeader{};
+    const unsigned char* imageData = nullptr;
+    unsigned char* decodedData = nullptr;
+    if (core::ReadDecodedImage(cachedImage, imageHeader, imageData))
+    {
+        width = imageHeader.width;
+        height = imageHeader.height;
+        channelInFile = imageHeader.channels;
+    }
+    else
+    {
+        decodedData = stbi_load_from_memory(file.data, file.size, &width, &height, &channelInFile, requiredChannels);
+        imageData = decodedData;
+        if (decodedData != nullptr)
+        {
+            core::StoreDecodedImage(assetCache, cacheKey, { width, height, requiredChannels, 1 }, decodedData);
+        }
+    }
     if (imageData == nullptr)
     {
         LogError(fmt::format("Could not decode image from path: {}", path));
@@ -72,7 +94,7 @@ bool Texture::LoadTexture(const core::pb::Texture& textureInfo)
     std::memcpy(data, imageData, static_cast<size_t>(imageSize));
     stagingBuffer.Unmap();
 
-    stbi_image_free(imageData);
+    stbi_image_free(decodedData);
 
     //TODO manage gamma format
     VkFormat format;
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "engine/filesystem.h"
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace core
+{
+
+/**
+ * @brief AssetCacheKey identifies derived data by the hash of its source content and the hash of its import settings,
+ * so changing either the source file or the way it is imported gives a new key
+ */
+struct AssetCacheKey
+{
+    std::uint64_t contentHash = 0;
+    std::uint64_t settingsHash = 0;
+    constexpr bool operator==(const AssetCacheKey& other) const = default;
+};
+
+AssetCacheKey MakeAssetCacheKey(std::span<const unsigned char> content, std::string_view importSettings);
+
+/**
+ * @brief AssetCacheEntryHeader starts a file of the asset cache, it is followed by the derived data
+ */
+struct AssetCacheEntryHeader
+{
+    std::array<char, 4> magic{};
+    std::uint32_t version = 0;
+    std::uint64_t contentHash = 0;
+    std::uint64_t settingsHash = 0;
+    std::uint64_t size = 0;
+    std::uint64_t dataHash = 0;
+};
+static_assert(sizeof(AssetCacheEntryHeader) == 40);
+
+static constexpr std::array<char, 4> ASSET_CACHE_MAGIC = {'N', 'D', 'D', 'C'};
+static constexpr std::uint32_t ASSET_CACHE_VERSION = 1;
+
+struct AssetCacheStats
+{
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t stores = 0;
+    std::uint64_t evictions = 0;
+    std::size_t size = 0;
+    std::size_t maxSize = 0;
+    std::size_t entryCount = 0;
+};
+
+/**
+ * @brief AssetCache is an on-disk cache of derived data, like imported meshes or decoded textures, ready to be uploaded.
+ * Entries are files of the cache directory on the disk, whatever the FilesystemInterface, and the least recently
+ * used ones are evicted when the cache is over its maximum size. It can be used from any thread.
+ */
+class AssetCache
+{
+public:
+    static constexpr std::size_t DEFAULT_MAX_SIZE = std::size_t{ 1024 } * 1024 * 1024;
+    /**
+     * @brief Open scans the cache directory, creating it if needed
+     */
+    bool Open(std::string_view directory, std::size_t maxSize = DEFAULT_MAX_SIZE);
+    void Close();
+    [[nodiscard]] bool IsOpen() const;
+    /**
+     * @brief Load returns the derived data of the key, or an empty FileBuffer on a miss or a corrupted entry
+     */
+    [[nodiscard]] FileBuffer Load(const AssetCacheKey& key);
+    void Store(const AssetCacheKey& key, std::span<const unsigned char> data);
+    void SetMaxSize(std::size_t maxSize);
+    [[nodiscard]] AssetCacheStats GetStats() const;
+    void ResetStats();
+private:
+    struct Entry
+    {
+        std::size_t size = 0;
+        std::uint64_t lastUse = 0;
+    };
+    [[nodiscard]] static std::string GetEntryName(const AssetCacheKey& key);
+    [[nodiscard]] std::string GetEntryPath(std::string_view entryName) const;
+    void Remove(const std::string& entryName);
+    /**
+     * @brief EvictOverSize must be called with the mutex locked
+     */
+    void EvictOverSize();
+
+    std::string directory_;
+    std::unordered_map<std::string, Entry> entries_;
+    std::uint64_t useCounter_ = 0;
+    AssetCacheStats stats_{};
+    mutable std::mutex mutex_;
+};
+
+} // namespace core
@@ -4,11 +4,13 @@
 
 #include <vector>
 
+#include "engine/asset_cache.h"
 #include "engine/system.h"
 #include "proto/config.pb.h"
 #include "renderer/texture.h"
 #include "renderer/model.h"
 #include "utils/job_system.h"
+#include "utils/job_graph.h"
 #include "engine/filesystem.h"
 
 #include <glm/ext/vector_uint2.hpp>
@@ -39,6 +41,10 @@ public:
     
     void RegisterEventObserver(OnEventInterface* eventInterface);
     void RegisterOnGuiInterface(OnGuiInterface* imguiDrawInterface);
+    /**
+     * @brief RegisterSystem adds a system to the engine. Systems whose declared SystemAccess do not conflict
+     * are updated concurrently, conflicting ones are updated in registration order.
+     */
     void RegisterSystem(System* system);
 
     void DisableImGui();
@@ -47,6 +53,7 @@ public:
     glm::uvec2 GetWindowSize() const;
     virtual TextureManager& GetTextureManager() = 0;
     ModelManager& GetModelManager();
+    AssetCache& GetAssetCache();
 
     enum class JobIndex
     {
@@ -75,12 +82,18 @@ protected:
     SDL_Window* window_ = nullptr;
     pb::Config config_;
     inline static constexpr core::Path configFilename = "config.bin";
+    static constexpr int FILE_IO_THREAD_COUNT = 8;
+    inline static constexpr std::string_view ASSET_CACHE_DIRECTORY = "asset_cache";
 
     std::array<std::shared_ptr<Job>, (int)JobIndex::LENGTH> jobs_;
 private:
+    core::AssetCache assetCache_;
     core::ModelManager modelManager_;
     core::JobSystem jobSystem_;
+    core::JobGraph frameGraph_;
     std::vector<System*> systems_;
+    std::vector<std::unique_ptr<Job>> systemUpdateJobs_;
+    int workerQueue_ = MAIN_QUEUE_INDEX;
     std::vector<OnEventInterface*> onEventInterfaces;
     std::vector<OnGuiInterface*> imguiDrawInterfaces;
 }; 
@@ -89,6 +102,10 @@ glm::uvec2 GetWindowSize();
 
 TextureManager& GetTextureManager();
 ModelManager& GetModelManager();
+/**
+ * @brief GetAssetCache returns the cache of derived data the importers consult, it can be used from any system
+ */
+AssetCache& GetAssetCache();
 
 void SetWindowName(std::string_view windowName);
 } // namespace core
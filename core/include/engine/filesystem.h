@@ -1,5 +1,6 @@
 #pragma once
 
+#include "utils/job_system.h"
 #include "utils/locator.h"
 
 #include <assimp/IOSystem.hpp>
@@ -7,8 +8,13 @@
 #include <fmt/format.h>
 
 #include <cassert>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
 #include <string_view>
 #include <array>
+#include <vector>
 
 
 
@@ -99,6 +105,17 @@ private:
 
 
     
+enum class FileAccessHint : std::uint8_t
+{
+    NONE,
+    SEQUENTIAL,
+    WILL_NEED
+};
+
+/**
+ * @brief FileBuffer is either a malloc allocated copy of a file, a read-only memory mapping of it,
+ * or a view on memory owned by someone else, like a mapped pack
+ */
 class FileBuffer
 {
 public:
@@ -110,27 +127,133 @@ public:
     {
         std::swap(data, other.data);
         std::swap(size, other.size);
+        std::swap(storage_, other.storage_);
     }
     FileBuffer& operator=(FileBuffer&& other) noexcept
     {
         std::swap(data, other.data);
         std::swap(size, other.size);
+        std::swap(storage_, other.storage_);
         return *this;
     }
+    /**
+     * @brief Map creates a read-only memory mapped FileBuffer, its data is null if the mapping failed.
+     * The data is null-terminated, except on Windows when the file size is a multiple of the page size.
+     */
+    static FileBuffer Map(std::string_view path, FileAccessHint hint = FileAccessHint::SEQUENTIAL);
+    /**
+     * @brief View creates a FileBuffer that does not own its data, the data must outlive it
+     */
+    static FileBuffer View(unsigned char* data, std::size_t size);
+    [[nodiscard]] static std::size_t GetPageSize();
+    /**
+     * @brief GetMappedSize returns the size of the mapping of a file, past its end when an extra zero page is needed
+     */
+    [[nodiscard]] static std::size_t GetMappedSize(std::size_t fileSize);
+    [[nodiscard]] bool IsMapped() const { return storage_ == Storage::MAPPED; }
+    [[nodiscard]] bool IsView() const { return storage_ == Storage::VIEW; }
 
     unsigned char* data = nullptr;
     std::size_t size = 0;
+private:
+    enum class Storage : std::uint8_t
+    {
+        HEAP,
+        MAPPED,
+        VIEW
+    };
+    Storage storage_ = Storage::HEAP;
+};
+
+/**
+ * @brief FileId identifies a file on its device, all the paths leading to the same file share it
+ */
+struct FileId
+{
+    std::uint64_t device = 0;
+    std::uint64_t index = 0;
+    constexpr bool operator==(const FileId& other) const = default;
+};
+
+constexpr FileId INVALID_FILE_ID = {};
+
+class FilesystemInterface;
+
+/**
+ * @brief FileLoadJob loads a file with a FilesystemInterface, its file buffer can be used once the job is done
+ */
+class FileLoadJob : public Job
+{
+public:
+    FileLoadJob(const FilesystemInterface& filesystem, const Path& path);
+    [[nodiscard]] const Path& GetPath() const { return path_; }
+    FileBuffer& GetFileBuffer() { return fileBuffer_; }
+protected:
+    void ExecuteImpl() override;
+private:
+    const FilesystemInterface& filesystem_;
+    Path path_;
+    FileBuffer fileBuffer_;
 };
 
+/**
+ * @brief FileLoadBatch is a group of asynchronous loads, its completion job is done when all the files are loaded
+ */
+struct FileLoadBatch
+{
+    std::vector<std::shared_ptr<FileLoadJob>> fileLoadJobs;
+    std::shared_ptr<Job> completionJob;
+};
+
+/**
+ * @brief FileLoadProgress receives the beginning of the file being loaded and the size already loaded
+ */
+using FileLoadProgress = std::function<void(const unsigned char* data, std::size_t loadedSize)>;
+
 class FilesystemInterface
 {
 public:
     virtual ~FilesystemInterface() = default;
     [[nodiscard]] virtual FileBuffer LoadFile(const Path &path) const = 0;
+    /**
+     * @brief LoadFileStreamed loads the file like LoadFile into a single buffer and calls onProgress from the loading
+     * thread each time about chunkSize more bytes are in place, except for the last ones. The filesystems that do not
+     * copy the file, or cannot load it in parts, just load it.
+     */
+    [[nodiscard]] virtual FileBuffer LoadFileStreamed(const Path &path, std::size_t chunkSize, const FileLoadProgress& onProgress) const
+    {
+        return LoadFile(path);
+    }
+    /**
+     * @brief GetFileSize returns the size of the file, or 0 when it does not exist or the filesystem cannot tell
+     */
+    [[nodiscard]] virtual std::size_t GetFileSize(const Path &path) const { return 0; }
+    /**
+     * @brief LoadFileAsync loads the file on the file I/O queue of the JobSystem, jobs can depend on the returned job
+     * and coroutines can wait for it. Without file I/O queue, the file is loaded immediately.
+     */
+    [[nodiscard]] std::shared_ptr<FileLoadJob> LoadFileAsync(const Path& path) const;
+    [[nodiscard]] FileLoadBatch LoadFilesAsync(std::span<const Path> paths) const;
+    /**
+     * @brief SetIoQueue sets the JobSystem queue executing the asynchronous loads, its threads mostly wait on the disk
+     * so it can have more threads than cores to keep many reads in flight
+     */
+    void SetIoQueue(int queueIndex) { ioQueue_ = queueIndex; }
+    [[nodiscard]] int GetIoQueue() const { return ioQueue_; }
     [[nodiscard]] virtual bool FileExists(const Path &path) const = 0;
     [[nodiscard]] virtual bool IsRegularFile(const Path &path) const = 0;
     [[nodiscard]] virtual bool IsDirectory(const Path &path) const = 0;
     virtual void WriteString(const Path &path, std::string_view content) const = 0;
+    /**
+     * @brief IsReadOnly tells if WriteString always fails, the optional writes like the config can then be skipped
+     */
+    [[nodiscard]] virtual bool IsReadOnly() const { return false; }
+    /**
+     * @brief GetFileId returns the identity of the file, or INVALID_FILE_ID when the filesystem has no such notion
+     */
+    [[nodiscard]] virtual FileId GetFileId(const Path &path) const { return INVALID_FILE_ID; }
+private:
+    int ioQueue_ = MAIN_QUEUE_INDEX;
 };
 
 class NullFilesystem final : public FilesystemInterface
@@ -141,6 +264,11 @@ public:
         assert(false);
         return {};
     }
+    [[nodiscard]] std::size_t GetFileSize(const Path &path) const override
+    {
+        assert(false);
+        return 0;
+    }
     [[nodiscard]] bool FileExists(const Path &path) const override
     {
         assert(false);
@@ -165,11 +293,34 @@ public:
 class DefaultFilesystem final : public FilesystemInterface
 {
 public:
+    DefaultFilesystem() = default;
+    /**
+     * @brief allowMemoryMapping must only be set by the programs that replace the files they load instead of rewriting
+     * them in place, like WriteString does, as reading the mapping of a truncated file crashes (SIGBUS)
+     */
+    explicit DefaultFilesystem(bool allowMemoryMapping) : allowMemoryMapping_(allowMemoryMapping) {}
+    /**
+     * @brief Files bigger than MEMORY_MAP_THRESHOLD are memory mapped instead of copied, when the memory mapping
+     * is allowed and as long as the mapping stays null-terminated
+     */
+    static constexpr std::size_t MEMORY_MAP_THRESHOLD = 1024 * 1024;
     [[nodiscard]] FileBuffer LoadFile(const Path &path) const override;
+    /**
+     * @brief LoadFileStreamed opens the file once and reads each chunk in place, the mapped files are returned whole
+     */
+    [[nodiscard]] FileBuffer LoadFileStreamed(const Path &path, std::size_t chunkSize, const FileLoadProgress& onProgress) const override;
+    [[nodiscard]] std::size_t GetFileSize(const Path &path) const override;
     [[nodiscard]] bool FileExists(const Path &path) const override;
     [[nodiscard]] bool IsRegularFile(const Path &path) const override;
     [[nodiscard]] bool IsDirectory(const Path &path) const override;
     void WriteString(const Path &path, std::string_view content) const override;
+    [[nodiscard]] FileId GetFileId(const Path &path) const override;
+private:
+    /**
+     * @brief CanMemoryMap tells if a file of fileSize is mapped, only when its mapping stays null-terminated
+     */
+    [[nodiscard]] bool CanMemoryMap(std::size_t fileSize) const;
+    bool allowMemoryMapping_ = false;
 };
 
 
@@ -213,6 +364,15 @@ struct std::hash<core::Path>
     }
 };
 
+template<>
+struct std::hash<core::FileId>
+{
+    std::size_t operator()(core::FileId const& s) const noexcept
+    {
+        return std::hash<std::uint64_t>{}(s.index ^ (s.device * 0x9E3779B97F4A7C15ull));
+    }
+};
+
 template<>
 struct fmt::formatter<core::Path>
 {
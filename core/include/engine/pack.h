@@ -0,0 +1,143 @@
+#pragma once
+
+#include "engine/filesystem.h"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace core
+{
+
+enum class PackCompression : std::uint8_t
+{
+    STORED,
+    ZSTD
+};
+
+/**
+ * @brief PackHeader starts a pack file, it is followed by the entries sorted by path hash and by the null-terminated
+ * entry paths. The entries data starts at dataOffset. Incremental writes append the new data and a new index at the
+ * end of the pack, the header pointing to the new index is written last.
+ */
+struct PackHeader
+{
+    std::array<char, 4> magic{};
+    std::uint32_t version = 0;
+    std::uint32_t entryCount = 0;
+    std::uint32_t chunkSize = 0;
+    std::uint64_t indexOffset = 0;
+    std::uint64_t pathsOffset = 0;
+    std::uint64_t dataOffset = 0;
+};
+static_assert(sizeof(PackHeader) == 40);
+
+/**
+ * @brief PackEntry describes a file of the pack. Stored entries are followed by at least one zero byte, so they can
+ * be used in place as null-terminated data. Compressed entries start with a table of the chunk stored sizes, whose
+ * high bit is set if the chunk was kept uncompressed, followed by the independently compressed chunks.
+ */
+struct PackEntry
+{
+    std::uint64_t pathHash = 0;
+    std::uint64_t contentHash = 0;
+    std::uint64_t offset = 0;
+    std::uint64_t size = 0;
+    std::uint64_t storedSize = 0;
+    std::uint32_t pathOffset = 0;
+    std::uint32_t pathLength = 0;
+    PackCompression compression = PackCompression::STORED;
+    std::array<std::uint8_t, 7> padding{};
+};
+static_assert(sizeof(PackEntry) == 56);
+
+static constexpr std::array<char, 4> PACK_MAGIC = {'N', 'P', 'A', 'K'};
+static constexpr std::uint32_t PACK_VERSION = 2;
+static constexpr std::uint64_t PACK_ALIGNMENT = 4096;
+static constexpr std::uint32_t PACK_CHUNK_SIZE = 64 * 1024;
+static constexpr std::uint32_t PACK_RAW_CHUNK_FLAG = 1u << 31u;
+
+/**
+ * @brief NormalizePackPath uses forward slashes and removes the leading "./" and "/" of a path
+ */
+std::string NormalizePackPath(std::string_view path);
+
+/**
+ * @brief PackWriter gathers files and writes them into a pack, compressing them chunk by chunk when it is worth it.
+ * Files are read, hashed and compressed in parallel on the JobSystem and identical files are stored once.
+ */
+class PackWriter
+{
+public:
+    /**
+     * @brief AddFile adds a file of the disk to the pack, by default at the same path
+     */
+    void AddFile(std::string_view diskPath, std::string_view packPath = {},
+        PackCompression compression = PackCompression::ZSTD);
+    void AddData(std::string_view packPath, std::string data, PackCompression compression = PackCompression::ZSTD);
+    /**
+     * @brief Write creates the pack or updates it incrementally. When a pack already exists at path, the files whose
+     * content did not change keep their data and only the changed ones are appended with the new index, unless the
+     * previous pack has too much unused data. An interrupted write leaves the previous pack readable.
+     */
+    bool Write(std::string_view path, int queueIndex = 0) const;
+private:
+    struct PackSource
+    {
+        std::string packPath;
+        std::string diskPath;
+        std::string data;
+        PackCompression compression = PackCompression::STORED;
+    };
+    std::vector<PackSource> sources_;
+};
+
+/**
+ * @brief PackFilesystem is a read-only FilesystemInterface on a memory mapped pack. Looking up a file is a binary
+ * search on the path hashes and stored files are returned without copy, so the pack must stay mounted while
+ * their FileBuffer are used.
+ */
+class PackFilesystem final : public FilesystemInterface
+{
+public:
+    bool Mount(std::string_view path);
+    void Unmount();
+    [[nodiscard]] bool IsMounted() const { return pack_.data != nullptr; }
+    [[nodiscard]] FileBuffer LoadFile(const Path &path) const override;
+    /**
+     * @brief LoadFileStreamed reports the progress of the decompression, stored files are returned without copy
+     */
+    [[nodiscard]] FileBuffer LoadFileStreamed(const Path &path, std::size_t chunkSize, const FileLoadProgress& onProgress) const override;
+    [[nodiscard]] std::size_t GetFileSize(const Path &path) const override;
+    [[nodiscard]] bool FileExists(const Path &path) const override;
+    [[nodiscard]] bool IsRegularFile(const Path &path) const override;
+    [[nodiscard]] bool IsDirectory(const Path &path) const override;
+    void WriteString(const Path &path, std::string_view content) const override;
+    [[nodiscard]] bool IsReadOnly() const override { return true; }
+private:
+    [[nodiscard]] const PackEntry* FindEntry(std::string_view path) const;
+    [[nodiscard]] std::string_view GetEntryPath(const PackEntry& entry) const;
+    /**
+     * @brief DecompressRange calls onProgress with the decompressed size each time progressSize more bytes are in place,
+     * except for the last ones
+     */
+    bool DecompressRange(const PackEntry& entry, std::size_t offset, std::size_t size, unsigned char* destination,
+        const FileLoadProgress& onProgress = {}, std::size_t progressSize = 0) const;
+    /**
+     * @brief HasContent compares the bytes of the entry with data, decompressing the entry if needed
+     */
+    [[nodiscard]] bool HasContent(const PackEntry& entry, std::string_view data) const;
+
+    FileBuffer pack_;
+    std::span<const PackEntry> entries_;
+    const char* paths_ = nullptr;
+    std::uint64_t dataOffset_ = 0;
+    std::uint32_t chunkSize_ = PACK_CHUNK_SIZE;
+
+    friend class PackWriter;
+};
+
+} // namespace core
@@ -2,8 +2,19 @@
 
 #include "engine/filesystem.h"
 #include "engine/system.h"
+#include "utils/job_pool.h"
 #include "utils/job_system.h"
 
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+
 namespace core
 {
 
@@ -24,6 +35,123 @@ struct Resource
     ResourceId resourceId = INVALID_RESOURCE_ID;
     int fileIndex = -1;
     bool hasLoaded = false;
+    bool isLoading = false;
+    // data of a resource being streamed, available up to loadedSize
+    const unsigned char* streamedData = nullptr;
+    std::size_t loadedSize = 0;
+    int refCount = 0;
+    // neighbours in the least recently used list of the unreferenced loaded resources
+    int lruPrevious = -1;
+    int lruNext = -1;
+};
+
+class ResourceManager;
+
+/**
+ * @brief ResourceHandle keeps a resource referenced, unreferenced resources can be evicted when the ResourceManager
+ * is over its memory budget. Like the ResourceManager, handles are used by systems with the FILE_BUFFERS access.
+ */
+class ResourceHandle
+{
+public:
+    ResourceHandle() = default;
+    ResourceHandle(ResourceManager* resourceManager, ResourceId resourceId);
+    ~ResourceHandle();
+    ResourceHandle(const ResourceHandle& other);
+    ResourceHandle& operator=(const ResourceHandle& other);
+    ResourceHandle(ResourceHandle&& other) noexcept;
+    ResourceHandle& operator=(ResourceHandle&& other) noexcept;
+
+    [[nodiscard]] ResourceId GetId() const { return resourceId_; }
+    [[nodiscard]] bool IsValid() const { return resourceId_ != INVALID_RESOURCE_ID; }
+    [[nodiscard]] bool HasLoaded() const;
+    [[nodiscard]] FileBuffer* GetFileBuffer() const;
+    void Reset();
+private:
+    ResourceManager* resourceManager_ = nullptr;
+    ResourceId resourceId_ = INVALID_RESOURCE_ID;
+};
+
+enum class ResourceLoadStage : std::uint8_t
+{
+    STREAMING,
+    READ,
+    DECODED
+};
+
+/**
+ * @brief ResourceCompletion is the progress of a resource load, published by a loader or a decoding thread.
+ * The data is available up to loadedSize, the file buffer slot of the resource is complete from the READ stage
+ * and its decoded data slot from the DECODED stage.
+ */
+struct ResourceCompletion
+{
+    ResourceId resourceId = INVALID_RESOURCE_ID;
+    const unsigned char* data = nullptr;
+    std::size_t loadedSize = 0;
+    ResourceLoadStage stage = ResourceLoadStage::STREAMING;
+};
+
+/**
+ * @brief ResourceDecoder turns the bytes of a resource into its decoded data, like the pixels of an image,
+ * a parsed mesh or a parsed proto. It is called on the worker queue once the file is read.
+ */
+using ResourceDecoder = std::function<std::shared_ptr<void>(const Path& path, const FileBuffer& fileBuffer)>;
+
+/**
+ * @brief ResourceLoadingLimits bound the loads in flight of each stage of the ResourceManager loading pipeline.
+ * The read files waiting for a decoding slot count in the I/O stage, so a slow decoding also slows the reads down.
+ */
+struct ResourceLoadingLimits
+{
+    /**
+     * @brief ioThreadCount is only used when the ResourceManager creates its own loader queue,
+     * without file I/O queue in the FilesystemInterface
+     */
+    int ioThreadCount = 2;
+    std::size_t maxIoLoads = 32;
+    std::size_t maxDecodes = 8;
+};
+
+/**
+ * @brief ResourceCompletionRing is a bounded lock-free MPSC ring buffer of completions, with a mutex-guarded overflow
+ * only used when the ring is full. The completions of a producer are popped in the order it pushed them.
+ */
+class ResourceCompletionRing
+{
+public:
+    static constexpr std::size_t CAPACITY = 1024;
+    ResourceCompletionRing();
+    ResourceCompletionRing(const ResourceCompletionRing&) = delete;
+    ResourceCompletionRing& operator= (const ResourceCompletionRing&) = delete;
+    void Push(const ResourceCompletion& completion);
+    /**
+     * @brief Pop must only be called by the consumer thread, returns false when there is no completion
+     */
+    bool Pop(ResourceCompletion& completion);
+private:
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "ResourceCompletionRing capacity must be a power of two");
+    bool TryPush(const ResourceCompletion& completion);
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence;
+        ResourceCompletion completion{};
+    };
+    std::unique_ptr<Cell[]> buffer_;
+    alignas(64) std::atomic<std::size_t> enqueuePos_{ 0 };
+    alignas(64) std::size_t dequeuePos_ = 0;
+    alignas(64) std::atomic<bool> hasOverflow_{ false };
+    std::mutex overflowMutex_;
+    std::deque<ResourceCompletion> overflow_;
+};
+
+struct ResourceCacheStats
+{
+    std::size_t residentBytes = 0;
+    std::size_t memoryBudget = 0;
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t evictions = 0;
 };
 
 
@@ -37,41 +165,131 @@ public:
     void Update(float dt) override;
 
     void End() override;
+    [[nodiscard]] SystemAccess GetAccess() const override;
 
-    ResourceId AddResource(std::string_view path);
+    /**
+     * @brief AddResource starts loading the resource if needed and returns a handle referencing it
+     */
+    ResourceHandle AddResource(std::string_view path);
     [[nodiscard]] bool HasLoaded(ResourceId resourceId) const;
+    /**
+     * @brief GetFileBuffer returns nullptr while the resource is loading. An evicted resource is loaded again,
+     * so its file buffer is available again after a few updates.
+     */
     FileBuffer* GetFileBuffer(ResourceId resourceId);
+    /**
+     * @brief GetLoadedData returns the part of the resource already loaded. Resources bigger than
+     * RESOURCE_STREAMING_THRESHOLD are streamed chunk by chunk, so their first bytes can be used while the rest
+     * is loading. It is the whole file once the resource has loaded.
+     */
+    [[nodiscard]] std::span<const unsigned char> GetLoadedData(ResourceId resourceId) const;
+    static constexpr std::size_t RESOURCE_STREAMING_THRESHOLD = 4 * 1024 * 1024;
+    static constexpr std::size_t RESOURCE_STREAMING_CHUNK_SIZE = 1024 * 1024;
+    /**
+     * @brief RegisterDecoder decodes the resources with the extension, like ".png", after they are read.
+     * Those resources only have loaded once decoded. The decoders must be registered before loading the resources.
+     */
+    void RegisterDecoder(std::string_view extension, ResourceDecoder decoder);
+    /**
+     * @brief GetDecodedData returns nullptr while the resource is loading or when it has no decoder
+     */
+    [[nodiscard]] std::shared_ptr<void> GetDecodedData(ResourceId resourceId) const;
+    template<typename T>
+    [[nodiscard]] std::shared_ptr<T> GetDecodedData(ResourceId resourceId) const
+    {
+        return std::static_pointer_cast<T>(GetDecodedData(resourceId));
+    }
+    /**
+     * @brief SetLoadingLimits must be called before Begin to change the I/O thread count
+     */
+    void SetLoadingLimits(const ResourceLoadingLimits& loadingLimits);
+    [[nodiscard]] const ResourceLoadingLimits& GetLoadingLimits() const { return loadingLimits_; }
+    /**
+     * @brief SetMemoryBudget sets the bytes of file buffers kept resident, the unreferenced resources are evicted
+     * in least recently used order above it. Referenced resources are never evicted.
+     */
+    void SetMemoryBudget(std::size_t memoryBudget);
+    [[nodiscard]] ResourceCacheStats GetCacheStats() const;
+    void ResetCacheStats();
 protected:
+    static constexpr std::uint32_t RESOURCE_JOB_POOL_SIZE = 256;
+    /**
+     * @brief LoadingResourceJob loads the file directly in the file buffer slot of the resource,
+     * and publishes its progress in the completion ring
+     */
     class LoadingResourceJob : public Job
     {
     public:
-        LoadingResourceJob(std::string_view path, ResourceId resourceId);
+        LoadingResourceJob(std::string_view path, ResourceId resourceId, FileBuffer* fileBuffer);
     private:
         void ExecuteImpl() override;
+        void StreamFile(const FilesystemInterface& filesystem);
 
-        std::string path_;
+        Path path_;
         ResourceId resourceId_;
-        FileBuffer fileBuffer_{};
+        FileBuffer* fileBuffer_ = nullptr;
     };
-    class MoveFileBufferJob : public Job
+    /**
+     * @brief DecodingResourceJob decodes a read file in the decoded data slot of the resource on the worker queue
+     */
+    class DecodingResourceJob : public Job
     {
     public:
-        MoveFileBufferJob(FileBuffer&& filebuffer, ResourceId resourceId);
-
-    protected:
+        DecodingResourceJob(const Resource& resource, const ResourceDecoder& decoder,
+            const FileBuffer& fileBuffer, std::shared_ptr<void>* decodedData);
+    private:
         void ExecuteImpl() override;
-        FileBuffer fileBuffer_;
+
+        Path path_;
         ResourceId resourceId_;
+        const ResourceDecoder& decoder_;
+        const FileBuffer& fileBuffer_;
+        std::shared_ptr<void>* decodedData_ = nullptr;
     };
+    void ApplyCompletion(const ResourceCompletion& completion);
+    ResourceHandle AddExistingResource(ResourceId resourceId);
+    void AddReference(ResourceId resourceId);
+    void RemoveReference(ResourceId resourceId);
+    void LoadResource(Resource& resource);
+    /**
+     * @brief DispatchLoads starts the pending decodes and loads while their stage is under its limit
+     */
+    void DispatchLoads();
+    void StartRead(Resource& resource);
+    void StartDecode(Resource& resource);
+    void FinishLoad(Resource& resource);
+    [[nodiscard]] const ResourceDecoder* FindDecoder(const Path& path) const;
+    void EvictOverBudget();
+    void RemoveFromLru(Resource& resource);
+    void PushToLru(Resource& resource);
+    [[nodiscard]] static std::size_t GetResourceIndex(ResourceId resourceId) { return resourceId.value - 1; }
+
     std::vector<Resource> resources_;
-    std::vector<FileBuffer> fileBuffers_;
-    std::queue<std::unique_ptr<MoveFileBufferJob>> moveFileBufferJobs_;
+    // resources by normalized path, and by file identity for the other paths leading to the same file
+    std::unordered_map<Path, ResourceId> resourcePathIndex_;
+    std::unordered_map<FileId, ResourceId> resourceFileIndex_;
+    // a deque keeps the address of the file buffer slots stable, the loader threads write in them directly
+    std::deque<FileBuffer> fileBuffers_;
+    std::deque<std::shared_ptr<void>> decodedData_;
+    std::unordered_map<std::string, ResourceDecoder> decoders_;
+    JobPool<LoadingResourceJob> loadingResourceJobPool_{ RESOURCE_JOB_POOL_SIZE };
+    JobPool<DecodingResourceJob> decodingResourceJobPool_{ RESOURCE_JOB_POOL_SIZE };
+    ResourceCompletionRing completionRing_;
+    std::vector<int> freeFileIndices_;
+    int lruHead_ = -1;
+    int lruTail_ = -1;
+    std::size_t memoryBudget_ = std::numeric_limits<std::size_t>::max();
+    ResourceCacheStats cacheStats_{};
+    ResourceLoadingLimits loadingLimits_{};
+    // the loads waiting for their stage, and the loads in flight in each stage
+    std::deque<ResourceId> pendingLoads_;
+    std::deque<ResourceId> pendingDecodes_;
+    std::size_t ioLoadsInFlight_ = 0;
+    std::size_t decodesInFlight_ = 0;
     int resourceLoadQueue_ = 0;
-#ifdef TRACY_ENABLE
-    mutable TracyLockable (std::mutex, resourceLoadMutex_);
-#else
-    mutable std::mutex resourceLoadMutex_;
-#endif
+    int resourceDecodeQueue_ = 0;
+
+    friend class ResourceHandle;
 };
 
 ResourceManager* GetResourceManager();
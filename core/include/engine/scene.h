@@ -117,6 +117,7 @@ public:
     void Begin() override;
     void Update(float dt) override;
     void End() override;
+    [[nodiscard]] SystemAccess GetAccess() const override;
     Scene* GetCurrentScene() const { return currentScene_; }
     void OnEvent(SDL_Event& event) override;
 private:
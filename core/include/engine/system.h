@@ -1,7 +1,51 @@
 #pragma once
 
+#include <cstdint>
+
 namespace core
 {
+/**
+ * @brief SystemResource is a bit flag of the engine data a system can access during its Update
+ */
+enum class SystemResource : std::uint32_t
+{
+    NONE = 0u,
+    SCENE = 1u << 0u,
+    SCRIPTS = 1u << 1u,
+    BUFFERS = 1u << 2u,
+    FILE_BUFFERS = 1u << 3u,
+    MODELS = 1u << 4u,
+    TEXTURES = 1u << 5u,
+    ALL = ~0u
+};
+
+constexpr SystemResource operator|(SystemResource a, SystemResource b)
+{
+    return static_cast<SystemResource>(static_cast<std::uint32_t>(a) | static_cast<std::uint32_t>(b));
+}
+
+constexpr SystemResource operator&(SystemResource a, SystemResource b)
+{
+    return static_cast<SystemResource>(static_cast<std::uint32_t>(a) & static_cast<std::uint32_t>(b));
+}
+
+/**
+ * @brief SystemAccess declares what a system reads and writes during its Update and if it needs the main thread.
+ * Systems that do not conflict can be updated concurrently on the job system.
+ */
+struct SystemAccess
+{
+    SystemResource reads = SystemResource::ALL;
+    SystemResource writes = SystemResource::ALL;
+    bool mainThread = true;
+
+    [[nodiscard]] constexpr bool ConflictsWith(const SystemAccess& other) const
+    {
+        return (writes & (other.reads | other.writes)) != SystemResource::NONE ||
+            (other.writes & reads) != SystemResource::NONE;
+    }
+};
+
 class System
 {
     public:
@@ -10,5 +54,29 @@ class System
     virtual void Begin() = 0;
     virtual void Update(float dt) = 0;
     virtual void End() = 0;
+    /**
+     * @brief GetAccess returns the declared access of Update, by default it writes everything on the main thread
+     */
+    [[nodiscard]] virtual SystemAccess GetAccess() const { return {}; }
 };
+
+/**
+ * @brief SystemAccessScope marks the system currently updated on this thread for the access validation
+ */
+class SystemAccessScope
+{
+public:
+    explicit SystemAccessScope(const System* system);
+    ~SystemAccessScope();
+    SystemAccessScope(const SystemAccessScope&) = delete;
+    SystemAccessScope& operator=(const SystemAccessScope&) = delete;
+private:
+    const System* previousSystem_ = nullptr;
+};
+
+/**
+ * @brief ValidateSystemAccess logs an error when the system updated on this thread did not declare the resource.
+ * It does nothing unless SYSTEM_VALIDATION_ENABLE is defined.
+ */
+void ValidateSystemAccess(SystemResource resource);
 } // namespace core
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "renderer/model.h"
+#include "renderer/vertex_layout.h"
 
 namespace core
 {
@@ -9,7 +10,7 @@ class VertexInputBuffer
 {
 public:
     virtual ~VertexInputBuffer() = default;
-    virtual void CreateFromMesh(const Mesh& mesh) = 0;
+    virtual void CreateFromMesh(const Mesh& mesh, pb::VertexLayout vertexLayout = pb::FULL_VERTEX) = 0;
     virtual void Bind() = 0;
     virtual void Destroy() = 0;
 };
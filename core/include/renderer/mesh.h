@@ -30,6 +30,9 @@ struct Mesh
     std::vector<Vertex> vertices;
     std::vector<unsigned> indices;
     unsigned materialIndex = std::numeric_limits<unsigned>::max();
+    // axis aligned bounds of the vertex positions, only set for the imported meshes
+    glm::vec3 boundsMin{ 0.0f };
+    glm::vec3 boundsMax{ 0.0f };
 };
 
 Mesh GenerateQuad(glm::vec3 scale, glm::vec3 offset);
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "renderer/mesh.h"
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace core
+{
+
+/**
+ * @brief MeshStreams is the struct-of-arrays form of a Mesh used by the CPU processing kernels,
+ * so a kernel only reads the streams it needs, contiguously. It is interleaved in Mesh::vertices once processed.
+ */
+struct MeshStreams
+{
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec2> texCoords;
+    std::vector<glm::vec3> normals;
+    std::vector<glm::vec3> tangents;
+    std::vector<glm::vec3> bitangents;
+    std::vector<unsigned> indices;
+
+    [[nodiscard]] std::size_t GetVertexCount() const { return positions.size(); }
+    void Resize(std::size_t vertexCount);
+};
+
+struct MeshBounds
+{
+    glm::vec3 min{ 0.0f };
+    glm::vec3 max{ 0.0f };
+};
+
+MeshStreams SplitMesh(const Mesh& mesh);
+/**
+ * @brief InterleaveMesh writes the streams in the vertices and indices of the mesh, in parallel over the vertices
+ */
+void InterleaveMesh(const MeshStreams& streams, Mesh& mesh);
+/**
+ * @brief ComputeBounds returns the axis aligned bounds of the positions, zero when there is none
+ */
+MeshBounds ComputeBounds(std::span<const glm::vec3> positions);
+
+} // namespace core
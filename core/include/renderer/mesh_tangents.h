@@ -0,0 +1,26 @@
+#pragma once
+
+#include "renderer/mesh.h"
+#include "renderer/mesh_streams.h"
+
+#include <cstdint>
+
+namespace core
+{
+
+enum class MeshTopology : std::uint8_t
+{
+    TRIANGLES,
+    TRIANGLE_STRIP
+};
+
+/**
+ * @brief GenerateTangents computes the tangent space of an indexed mesh from its positions, texture coordinates and
+ * normals. The triangle tangents are accumulated weighted by their area, the degenerate ones are skipped,
+ * then each tangent is made orthogonal to its normal and the bitangent is sign * cross(normal, tangent),
+ * as with MikkTSpace. The triangles are processed in SIMD over the streams and the vertices in parallel.
+ */
+void GenerateTangents(MeshStreams& streams, MeshTopology topology = MeshTopology::TRIANGLES);
+void GenerateTangents(Mesh& mesh, MeshTopology topology = MeshTopology::TRIANGLES);
+
+} // namespace core
@@ -2,6 +2,7 @@
 
 #include "proto/renderer.pb.h"
 #include "renderer/mesh.h"
+#include "engine/asset_cache.h"
 #include "engine/filesystem.h"
 
 #include <assimp/Importer.hpp>
@@ -22,6 +23,63 @@ struct ModelMaterial
     std::array<std::string, core::pb::TextureType::LENGTH> textures;
 };
 
+/**
+ * @brief ModelFileString is a string of the strings block of a model file, not null-terminated
+ */
+struct ModelFileString
+{
+    std::uint32_t offset = 0;
+    std::uint32_t length = 0;
+};
+
+/**
+ * @brief ModelFileHeader starts a binary model file. It is followed by the mesh table, the material table and the
+ * strings block. The vertex and index arrays come after, each aligned on MODEL_FILE_ALIGNMENT, so a memory mapped
+ * model file can be used without any per-vertex work. Offsets are from the start of the file.
+ */
+struct ModelFileHeader
+{
+    std::array<char, 4> magic{};
+    std::uint32_t version = 0;
+    std::uint32_t meshCount = 0;
+    std::uint32_t materialCount = 0;
+    std::uint64_t meshesOffset = 0;
+    std::uint64_t materialsOffset = 0;
+    std::uint64_t stringsOffset = 0;
+    std::uint64_t fileSize = 0;
+    std::array<float, 3> boundsMin{};
+    std::array<float, 3> boundsMax{};
+};
+static_assert(sizeof(ModelFileHeader) == 72);
+
+struct ModelFileMesh
+{
+    ModelFileString name{};
+    std::uint32_t materialIndex = 0;
+    std::uint32_t padding = 0;
+    std::uint64_t verticesOffset = 0;
+    std::uint64_t vertexCount = 0;
+    std::uint64_t indicesOffset = 0;
+    std::uint64_t indexCount = 0;
+    std::array<float, 3> boundsMin{};
+    std::array<float, 3> boundsMax{};
+};
+static_assert(sizeof(ModelFileMesh) == 64);
+
+struct ModelFileMaterial
+{
+    ModelFileString name{};
+    std::array<ModelFileString, core::pb::TextureType::LENGTH> textures{};
+};
+
+static constexpr std::array<char, 4> MODEL_FILE_MAGIC = {'N', 'M', 'D', 'L'};
+static constexpr std::uint32_t MODEL_FILE_VERSION = 1;
+static constexpr std::uint64_t MODEL_FILE_ALIGNMENT = 16;
+/**
+ * @brief MODEL_FILE_EXTENSION is the extension of the binary model files written by the editor at import
+ */
+static constexpr std::string_view MODEL_FILE_EXTENSION = ".bmodel";
+
 
 
 struct ModelIndex
@@ -46,10 +104,23 @@ public:
     [[nodiscard]] std::span<const ModelMaterial> GetMaterials() const { return materials_; }
     const Mesh& GetMesh(std::string_view meshName);
 
+    /**
+     * @brief Serialize writes the model in the binary model file format, also used for the AssetCache entries
+     */
+    [[nodiscard]] std::string Serialize() const;
+    /**
+     * @brief Deserialize reads a binary model file, the vertex and index arrays are copied as a whole
+     */
+    bool Deserialize(std::span<const unsigned char> data);
+
 protected:
+    /**
+     * @brief LoadFromNode converts each mesh of the node tree in its own task, in the order of the tree
+     */
     void LoadFromNode(const aiScene* scene, const aiNode* node);
+    static void CollectNodeMeshes(const aiScene* scene, const aiNode* node, std::vector<const aiMesh*>& aiMeshes);
     void LoadMaterials(const aiScene* scene);
-    void LoadMesh(const aiMesh* aiMesh);
+    static void LoadMesh(const aiMesh* aiMesh, Mesh& mesh);
     friend class ModelManager;
     std::vector<Mesh> meshes_;
     std::vector<ModelMaterial> materials_;
@@ -60,16 +131,29 @@ protected:
 class ModelManager final
 {
 public:
-    ModelManager();
+    /**
+     * @brief ImportModel loads binary model files directly. Other files are imported with Assimp,
+     * unless the imported model is in the AssetCache.
+     */
     ModelIndex ImportModel(const core::Path &modelPath);
+    /**
+     * @brief ImportModels imports each model file in its own task, with its own importer, so a scene with many
+     * models loads in about the time of its biggest one. The models are added in the order of the paths.
+     */
+    std::vector<ModelIndex> ImportModels(std::span<const core::Path> modelPaths);
+    void SetAssetCache(AssetCache* assetCache) { assetCache_ = assetCache; }
     [[nodiscard]] Model& GetModel(ModelIndex index) { return models_[index.index]; }
     [[nodiscard]] const Model& GetModel(ModelIndex index) const { return models_[index.index]; }
     void Clear();
 
 protected:
-    ModelIndex ImportScene(const aiScene* scene);
+    /**
+     * @brief LoadModel can be called from any thread, the AssetCache is thread-safe
+     */
+    bool LoadModel(const core::Path &modelPath, Model& model) const;
+    ModelIndex AddModel(Model&& model);
     std::unordered_map<std::string, ModelIndex> modelNamesMap_;
     std::vector<Model> models_;
-    Assimp::Importer importer_;
+    AssetCache* assetCache_ = nullptr;
 };
 } // namespace core
@@ -1,12 +1,33 @@
 #pragma once
 
+#include "engine/asset_cache.h"
 #include "proto/renderer.pb.h"
 
+#include <cstdint>
+
 namespace core
 {
 enum class TextureId : int {};
 constexpr TextureId INVALID_TEXTURE_ID = TextureId{ -1 };
 
+/**
+ * @brief DecodedImageHeader starts the AssetCache entry of a decoded image, it is followed by the pixels
+ */
+struct DecodedImageHeader
+{
+    std::int32_t width = 0;
+    std::int32_t height = 0;
+    std::int32_t channels = 0;
+    std::int32_t bytesPerChannel = 1;
+};
+
+/**
+ * @brief ReadDecodedImage reads a cached decoded image, the pixels point in the cache entry
+ */
+bool ReadDecodedImage(const FileBuffer& cacheEntry, DecodedImageHeader& header, const unsigned char*& pixels);
+void StoreDecodedImage(AssetCache& assetCache, const AssetCacheKey& key, const DecodedImageHeader& header,
+    const unsigned char* pixels);
+
 class Texture
 {
 public:
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "proto/renderer.pb.h"
+#include "renderer/mesh.h"
+
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+namespace core
+{
+
+enum class VertexAttributeType : std::uint8_t
+{
+    FLOAT,
+    HALF_FLOAT,
+    SNORM16,
+    SNORM8
+};
+
+struct VertexAttributeFormat
+{
+    VertexAttributeType type = VertexAttributeType::FLOAT;
+    std::uint32_t componentCount = 0;
+    std::uint32_t offset = 0;
+};
+
+static constexpr std::size_t MAX_VERTEX_ATTRIBUTES = 5;
+
+/**
+ * @brief VertexLayoutInfo describes the attributes of a vertex layout, in the order of their location.
+ * The normalized attributes are read as floats by the shaders, so the same shaders work with every layout,
+ * except for the bitangent of the compact layouts, rebuilt from the tangent sign, and the quantized positions.
+ */
+struct VertexLayoutInfo
+{
+    std::uint32_t stride = 0;
+    std::uint32_t attributeCount = 0;
+    std::array<VertexAttributeFormat, MAX_VERTEX_ATTRIBUTES> attributes{};
+};
+
+[[nodiscard]] const VertexLayoutInfo& GetVertexLayoutInfo(pb::VertexLayout vertexLayout);
+
+/**
+ * @brief CheckVertexLayouts logs every draw command whose mesh is not in the vertex layout of its pipeline,
+ * and every pipeline reading more vertex attributes than its layout has, returns false if there is any
+ */
+[[nodiscard]] bool CheckVertexLayouts(const pb::Scene& scene);
+
+/**
+ * @brief PositionQuantization gives back the positions of a QUANTIZED_VERTEX mesh: position = quantized * scale + offset.
+ * The renderers set it in the vertex shader uniforms below when they are declared, the other layouts give the identity.
+ */
+struct PositionQuantization
+{
+    glm::vec3 scale{ 1.0f };
+    glm::vec3 offset{ 0.0f };
+};
+
+static constexpr std::string_view POSITION_QUANTIZATION_SCALE = "positionQuantization.scale";
+static constexpr std::string_view POSITION_QUANTIZATION_OFFSET = "positionQuantization.offset";
+
+/**
+ * @brief EncodeVertices writes the vertices in the vertex layout, like a mapped GPU buffer,
+ * out must be at least the vertex count times the layout stride
+ */
+PositionQuantization EncodeVertices(std::span<const Vertex> vertices, pb::VertexLayout vertexLayout, std::span<std::byte> out);
+
+} // namespace core
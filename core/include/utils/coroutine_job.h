@@ -0,0 +1,127 @@
+#pragma once
+
+#include "utils/job_system.h"
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace core
+{
+class CoroutineJob;
+
+/**
+ * @brief JobTask is the coroutine type executed by a CoroutineJob
+ */
+class JobTask
+{
+public:
+    struct promise_type
+    {
+        CoroutineJob* job = nullptr;
+        JobTask get_return_object() { return JobTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+    using Handle = std::coroutine_handle<promise_type>;
+
+    JobTask() = default;
+    explicit JobTask(Handle handle) : handle_(handle) {}
+    ~JobTask();
+    JobTask(const JobTask&) = delete;
+    JobTask& operator=(const JobTask&) = delete;
+    JobTask(JobTask&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    JobTask& operator=(JobTask&& other) noexcept;
+    [[nodiscard]] Handle GetHandle() const { return handle_; }
+private:
+    Handle handle_{};
+};
+
+/**
+ * @brief CompletionToken is a fence-like event. Coroutine jobs can co_await it, they are scheduled again when it is signaled
+ */
+class CompletionToken
+{
+public:
+    void Signal();
+    [[nodiscard]] bool IsSignaled() const;
+    /**
+     * @brief Reset must not be called while jobs are waiting on the token
+     */
+    void Reset();
+
+    struct Awaiter
+    {
+        CompletionToken& token;
+        [[nodiscard]] bool await_ready() const { return token.IsSignaled(); }
+        bool await_suspend(JobTask::Handle handle);
+        void await_resume() const {}
+    };
+    Awaiter operator co_await() { return { *this }; }
+private:
+    void Lock();
+    void Unlock();
+    std::atomic_flag lock_ = ATOMIC_FLAG_INIT;
+    std::atomic<bool> isSignaled_{ false };
+    std::vector<CoroutineJob*> waitingJobs_;
+};
+
+/**
+ * @brief CoroutineJob is a job running a coroutine. When the coroutine co_awaits, the worker executes other jobs
+ * instead of blocking, and the job is scheduled again when what it waits for is done.
+ * The coroutine is created again each time the job is added to the JobSystem.
+ */
+class CoroutineJob : public Job
+{
+public:
+    explicit CoroutineJob(const std::function<JobTask(void)>& coroutineFunc) : coroutineFunc_(coroutineFunc) {}
+
+    struct JobAwaiter
+    {
+        Job& job;
+        [[nodiscard]] bool await_ready() const { return job.IsDone(); }
+        bool await_suspend(JobTask::Handle handle);
+        void await_resume() const {}
+    };
+    struct QueueAwaiter
+    {
+        int queueIndex;
+        [[nodiscard]] bool await_ready() const { return false; }
+        void await_suspend(JobTask::Handle handle);
+        void await_resume() const {}
+    };
+protected:
+    void ExecuteImpl() override;
+private:
+    friend class CompletionToken;
+    /**
+     * @brief BeginWait makes the job wait for one release, the execution is only suspended by Suspend
+     */
+    void BeginWait();
+    void CancelWait();
+    void Suspend();
+    void Release();
+    void SwitchQueue(int queueIndex);
+    void Reschedule();
+    bool AddToSuccessors(Job& job);
+
+    std::function<JobTask(void)> coroutineFunc_;
+    JobTask task_;
+};
+
+/**
+ * @brief WaitForJob suspends the coroutine until the job is done. The job must have been added to the JobSystem.
+ */
+CoroutineJob::JobAwaiter WaitForJob(Job& job);
+/**
+ * @brief SwitchToQueue resumes the coroutine on the given queue, for example a loading queue for blocking reads
+ * or MAIN_QUEUE_INDEX for render API calls.
+ */
+CoroutineJob::QueueAwaiter SwitchToQueue(int queueIndex);
+
+} // namespace core
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace core
+{
+
+/**
+ * @brief HashString is a 64 bits FNV-1a hash, usable at compile time
+ */
+constexpr std::uint64_t HashString(std::string_view str)
+{
+    std::uint64_t hash = 14695981039346656037ull;
+    for (const char c : str)
+    {
+        hash ^= static_cast<std::uint8_t>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * @brief HashBytes is a 64 bits hash of a memory block reading 8 bytes at a time, much faster than HashString on
+ * big blocks like file contents
+ */
+inline std::uint64_t HashBytes(const void* data, std::size_t size, std::uint64_t seed = 0)
+{
+    constexpr std::uint64_t multiplier = 0x9E3779B97F4A7C15ull;
+    const auto mix = [](std::uint64_t value)
+    {
+        value ^= value >> 31u;
+        value *= 0xBF58476D1CE4E5B9ull;
+        value ^= value >> 29u;
+        return value;
+    };
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    std::uint64_t hash = seed ^ (size * multiplier);
+    std::size_t index = 0;
+    for (; index + sizeof(std::uint64_t) <= size; index += sizeof(std::uint64_t))
+    {
+        std::uint64_t word;
+        std::memcpy(&word, bytes + index, sizeof(word));
+        hash = (hash ^ mix(word)) * multiplier;
+        hash = (hash << 27u) | (hash >> 37u);
+    }
+    std::uint64_t tail = 0;
+    if (index < size)
+    {
+        std::memcpy(&tail, bytes + index, size - index);
+    }
+    hash = (hash ^ mix(tail)) * multiplier;
+    return mix(hash ^ (hash >> 32u));
+}
+
+} // namespace core
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "utils/job_system.h"
+
+#include <vector>
+
+namespace core
+{
+
+/**
+ * @brief JobGraph is a set of jobs and their dependencies that is compiled once and replayed every frame.
+ * Running it resets all its jobs in bulk and adds them to the JobSystem in topological order,
+ * without heap allocation nor reference counting. The graph does not own its jobs.
+ */
+class JobGraph
+{
+public:
+    void AddJob(Job* job, int queueIndex = MAIN_QUEUE_INDEX);
+    bool AddDependency(Job* job, Job* dependency);
+    /**
+     * @brief Compile sorts the jobs in topological order, it must be called after adding jobs or dependencies
+     */
+    bool Compile();
+    void Run(JobSystem& jobSystem);
+    void Clear();
+    [[nodiscard]] bool IsCompiled() const { return isCompiled_; }
+    [[nodiscard]] std::size_t GetJobCount() const { return nodes_.size(); }
+private:
+    struct Node
+    {
+        Job* job = nullptr;
+        int queueIndex = MAIN_QUEUE_INDEX;
+    };
+    std::vector<Node> nodes_;
+    bool isCompiled_ = false;
+};
+
+} // namespace core
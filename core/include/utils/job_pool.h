@@ -0,0 +1,136 @@
+#pragma once
+
+#include "utils/job_system.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace core
+{
+
+/**
+ * @brief JobPoolBase is the untyped storage of a JobPool, a fixed number of blocks linked in a lock-free free list
+ */
+class JobPoolBase
+{
+public:
+    JobPoolBase(std::size_t blockSize, std::size_t blockAlignment, std::uint32_t capacity);
+    virtual ~JobPoolBase();
+    JobPoolBase(const JobPoolBase&) = delete;
+    JobPoolBase& operator=(const JobPoolBase&) = delete;
+    [[nodiscard]] std::uint32_t GetCapacity() const { return capacity_; }
+protected:
+    friend class Job;
+    friend class JobSystem;
+    /**
+     * @brief Release destroys a done job and gives its storage back to the pool
+     */
+    virtual void Release(Job* job) = 0;
+    /**
+     * @brief AllocateBlock returns nullptr when all the blocks are used
+     */
+    void* AllocateBlock();
+    void ReleaseBlock(void* block);
+    [[nodiscard]] bool Owns(const void* ptr) const;
+private:
+    static constexpr std::uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+    std::byte* blocks_ = nullptr;
+    std::unique_ptr<std::atomic<std::uint32_t>[]> nextFree_;
+    /**
+     * @brief freeHead_ packs the first free block index with a tag incremented on each change, to avoid ABA
+     */
+    std::atomic<std::uint64_t> freeHead_{ 0 };
+    std::size_t blockSize_ = 0;
+    std::size_t blockAlignment_ = 0;
+    std::uint32_t capacity_ = 0;
+};
+
+/**
+ * @brief JobPool gives allocation-free storage to fire-and-forget jobs. A pooled job is destroyed and its storage
+ * recycled as soon as it is done, so it must not be used as a dependency nor queried once added to the JobSystem.
+ * When the pool is full, jobs are allocated on the heap and counted in the JobAllocationCounters.
+ */
+template<typename T>
+class JobPool : public JobPoolBase
+{
+public:
+    static_assert(std::is_base_of_v<Job, T>, "JobPool can only store jobs");
+    explicit JobPool(std::uint32_t capacity) : JobPoolBase(sizeof(T), alignof(T), capacity) {}
+
+    template<typename... Args>
+    T* Acquire(Args&&... args)
+    {
+        T* job = nullptr;
+        if (auto* block = AllocateBlock(); block != nullptr)
+        {
+            job = ::new (block) T(std::forward<Args>(args)...);
+        }
+        else
+        {
+            job = new T(std::forward<Args>(args)...);
+        }
+        job->pool_ = this;
+        return job;
+    }
+    /**
+     * @brief Free destroys a job that was acquired but never executed
+     */
+    void Free(T* job)
+    {
+        Release(job);
+    }
+protected:
+    void Release(Job* job) override
+    {
+        auto* typedJob = static_cast<T*>(job);
+        if (!Owns(typedJob))
+        {
+            delete typedJob;
+            return;
+        }
+        typedJob->~T();
+        ReleaseBlock(typedJob);
+    }
+};
+
+/**
+ * @brief InlineFuncJob stores its callable inline instead of in a std::function, creating it does not allocate
+ */
+template<std::size_t Capacity = 48>
+class InlineFuncJob : public Job
+{
+public:
+    template<typename Func>
+        requires (!std::is_same_v<std::decay_t<Func>, InlineFuncJob> && std::is_invocable_v<std::decay_t<Func>&>)
+    explicit InlineFuncJob(Func&& func)
+    {
+        using FuncType = std::decay_t<Func>;
+        static_assert(sizeof(FuncType) <= Capacity, "InlineFuncJob callable is too big for its capacity");
+        static_assert(alignof(FuncType) <= alignof(std::max_align_t), "InlineFuncJob callable is over-aligned");
+        ::new (static_cast<void*>(storage_)) FuncType(std::forward<Func>(func));
+        invoke_ = [](void* storage) { (*static_cast<FuncType*>(storage))(); };
+        destroy_ = [](void* storage) { static_cast<FuncType*>(storage)->~FuncType(); };
+    }
+    ~InlineFuncJob() override
+    {
+        destroy_(storage_);
+    }
+    InlineFuncJob(const InlineFuncJob&) = delete;
+    InlineFuncJob& operator=(const InlineFuncJob&) = delete;
+protected:
+    void ExecuteImpl() override
+    {
+        invoke_(storage_);
+    }
+private:
+    alignas(std::max_align_t) std::byte storage_[Capacity];
+    void (*invoke_)(void*) = nullptr;
+    void (*destroy_)(void*) = nullptr;
+};
+
+} // namespace core
@@ -1,27 +1,184 @@
 #pragma once
 
-#include <memory>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
 #include <thread>
-#include <queue>
-#include <shared_mutex>
+#include <vector>
 
 namespace core
 {
+class Job;
+class JobSystem;
+class JobPoolBase;
+template<typename T>
+class JobPool;
+
+enum class JobAllocationType : std::uint8_t
+{
+    HEAP,
+    POOL,
+    POOL_OVERFLOW,
+    LENGTH
+};
+
+/**
+ * @brief JobAllocationCounters are cumulative, allocations per frame are the difference between two frames
+ */
+struct JobAllocationCounters
+{
+    std::uint64_t heapAllocations = 0;
+    std::uint64_t poolAllocations = 0;
+    std::uint64_t poolOverflows = 0;
+};
+
+void CountJobAllocation(JobAllocationType type);
+JobAllocationCounters GetJobAllocationCounters();
+
+/**
+ * @brief JobPriority orders the jobs waiting in a WorkerQueue, from the most urgent to the least
+ */
+enum class JobPriority : std::uint8_t
+{
+    CRITICAL,
+    FRAME,
+    NORMAL,
+    BACKGROUND,
+    LENGTH
+};
+
+/**
+ * @brief JobDependencyType tells what a dependent waits for, the completion of its dependency or only its start
+ */
+enum class JobDependencyType : std::uint8_t
+{
+    COMPLETION,
+    START
+};
+
+/**
+ * @brief JobDependency is a dependency given as a raw pointer, which must outlive the dependent,
+ * or as a weak_ptr, which counts as done once it expired
+ */
+struct JobDependency
+{
+    Job* job = nullptr;
+    std::weak_ptr<Job> owner{};
+    JobDependencyType type = JobDependencyType::COMPLETION;
+    bool isOwned = false;
+    /**
+     * @brief Lock returns the dependency, holding it if it is owned, or null if it expired
+     */
+    [[nodiscard]] std::shared_ptr<Job> Lock() const;
+};
+
+/**
+ * @brief Job is the unit of work of the JobSystem. Each job keeps an atomic counter of pending dependencies,
+ * when a job is done it decrements the counter of its successors and schedules the ones reaching zero.
+ * A dependency that already ran must be added again to the JobSystem before its dependents,
+ * otherwise they see it as done.
+ */
 class Job
 {
 public:
-    virtual ~Job() = default;
-    void Execute();
+    /**
+     * @brief Destroying a job that never ran releases its successors, as an expired dependency counts as done
+     */
+    virtual ~Job();
+    /**
+     * @brief Job heap allocations are counted, apart from the ones done by std::make_shared
+     */
+    static void* operator new(std::size_t size);
+    static void operator delete(void* ptr) noexcept;
+    /**
+     * @brief Execute runs the job, returns false if the job suspended itself to wait for something.
+     * A suspended job is scheduled again by what it waits for, and must not be accessed by the caller.
+     */
+    bool Execute();
     bool HasStarted() const;
     bool IsDone() const;
-    virtual bool ShouldStart() const;
+    [[nodiscard]] bool ShouldStart() const;
     void Reset();
+    /**
+     * @brief AddDependency makes this job wait for the completion of the dependency, or only its start.
+     * Returns false and does not add it if it would create a cycle.
+     */
+    bool AddDependency(Job* dependency, JobDependencyType type = JobDependencyType::COMPLETION);
+    bool AddDependency(const std::weak_ptr<Job>& dependency, JobDependencyType type = JobDependencyType::COMPLETION);
+    [[nodiscard]] bool DependsOn(const Job* job) const;
+    /**
+     * @brief SetPriority must be called before the job is added to the JobSystem
+     */
+    void SetPriority(JobPriority priority) { priority_ = priority; }
+    [[nodiscard]] JobPriority GetPriority() const { return priority_; }
 protected:
     virtual void ExecuteImpl() = 0;
 private:
+    friend class JobSystem;
+    friend class JobGraph;
+    friend class CoroutineJob;
+    template<typename T>
+    friend class JobPool;
+    /**
+     * @brief SuspendCurrentExecution marks the job executing on this thread as suspended, Execute will return without completing it
+     */
+    static void SuspendCurrentExecution();
+    [[nodiscard]] static bool IsCurrentExecutionSuspended();
+    bool AddDependency(JobDependency dependency);
+    /**
+     * @brief AddSuccessor registers a job to be released when this job is done, or when it starts,
+     * returns false if it is already done or started
+     */
+    bool AddSuccessor(Job* successor, JobDependencyType type = JobDependencyType::COMPLETION);
+    /**
+     * @brief DetachFromDependencies removes the job from the successors of its dependencies, before it is discarded
+     * without having run
+     */
+    void DetachFromDependencies();
+    /**
+     * @brief ReleaseSuccessors decrements the successors counters and schedules the ones reaching zero,
+     * the successors lock must be held
+     */
+    static void ReleaseSuccessors(std::vector<Job*>& successors);
+    void LockSuccessors();
+    void UnlockSuccessors();
+
     std::atomic<bool> hasStarted_{ false };
     std::atomic<bool> isDone_{ false };
+    /**
+     * @brief pendingDependencies_ counts the dependencies not done yet, plus one released when the job is added
+     */
+    std::atomic<int> pendingDependencies_{ 1 };
+    std::vector<JobDependency> dependencies_;
+    /**
+     * @brief successors_ are kept from their registration until this job is done, so a dependent added
+     * before this job is not lost when this job is reset
+     */
+    std::vector<Job*> successors_;
+    std::vector<Job*> startSuccessors_;
+    std::atomic_flag successorsLock_ = ATOMIC_FLAG_INIT;
+    bool successorsClosed_ = false;
+    bool startSuccessorsClosed_ = false;
+    /**
+     * @brief keepAlive_ holds the job while it is in the JobSystem, as the queues only store raw pointers
+     */
+    std::shared_ptr<Job> keepAlive_;
+    JobSystem* jobSystem_ = nullptr;
+    /**
+     * @brief pool_ is set for pooled jobs, they are released to their pool instead of being marked as done
+     */
+    JobPoolBase* pool_ = nullptr;
+    std::chrono::steady_clock::time_point scheduleTime_{};
+    int queueIndex_ = -1;
+    JobPriority priority_ = JobPriority::NORMAL;
+    bool isPendingMainJob_ = false;
 };
 
 class FuncJob : public Job
@@ -37,91 +194,400 @@ private:
 class DependenciesJob : public Job
 {
 public:
-    DependenciesJob(std::initializer_list<std::weak_ptr<Job>> dependencies) : dependencies_(dependencies) {}
-    [[nodiscard]] bool ShouldStart() const override;
+    DependenciesJob(std::initializer_list<std::weak_ptr<Job>> dependencies);
+};
 
-    void AddDependency(const std::weak_ptr<Job>& dependency);
+class FuncDependentJob : public FuncJob
+{
+public:
+    FuncDependentJob(const std::weak_ptr<Job>& dependency, const std::function<void(void)>& func);
+};
 
+class FuncDependenciesJob: public FuncJob
+{
+public:
+    FuncDependenciesJob(std::initializer_list<std::weak_ptr<Job>> dependencies, const std::function<void(void)>& func);
+};
+
+/**
+ * @brief WorkStealingDeque is a bounded Chase-Lev deque. The owner worker pushes and pops at the bottom (LIFO),
+ * while other threads steal from the top (FIFO) without taking any lock.
+ */
+class WorkStealingDeque
+{
+public:
+    static constexpr std::int64_t CAPACITY = 4096;
+    /**
+     * @brief Push must only be called by the owner thread, returns false when the deque is full
+     */
+    bool Push(Job* job);
+    /**
+     * @brief Pop must only be called by the owner thread
+     */
+    Job* Pop();
+    Job* Steal();
+    [[nodiscard]] bool IsEmpty() const;
 private:
-    std::vector<std::weak_ptr<Job>> dependencies_{};
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "WorkStealingDeque capacity must be a power of two");
+    alignas(64) std::atomic<std::int64_t> top_{ 0 };
+    alignas(64) std::atomic<std::int64_t> bottom_{ 0 };
+    alignas(64) std::array<std::atomic<Job*>, CAPACITY> buffer_{};
 };
 
-class FuncDependentJob : public FuncJob
+/**
+ * @brief JobRing is a bounded lock-free MPMC ring buffer, with a mutex-guarded overflow only used when the ring is full.
+ */
+class JobRing
 {
 public:
-    FuncDependentJob(std::weak_ptr<Job> dependency, const std::function<void(void)>& func) :
-        dependency_(dependency),
-        FuncJob(func)
+    static constexpr std::size_t CAPACITY = 4096;
+    JobRing();
+    JobRing(const JobRing&) = delete;
+    JobRing& operator= (const JobRing&) = delete;
+    void Push(Job* newJob);
+    [[nodiscard]] bool IsEmpty() const;
+    Job* Pop();
+    /**
+     * @brief GetSize is approximate when other threads push or pop concurrently
+     */
+    [[nodiscard]] std::size_t GetSize() const;
+    [[nodiscard]] std::uint64_t GetPushCount() const;
+    [[nodiscard]] std::uint64_t GetOverflowPushCount() const { return overflowPushes_.load(std::memory_order_relaxed); }
+private:
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "JobRing capacity must be a power of two");
+    bool TryPush(Job* newJob);
+    Job* TryPop();
+    struct Cell
     {
+        std::atomic<std::size_t> sequence;
+        Job* job = nullptr;
+    };
+    std::unique_ptr<Cell[]> buffer_;
+    alignas(64) std::atomic<std::size_t> enqueuePos_{ 0 };
+    alignas(64) std::atomic<std::size_t> dequeuePos_{ 0 };
+    alignas(64) std::atomic<bool> hasOverflow_{ false };
+    std::atomic<std::uint64_t> overflowPushes_{ 0 };
+    mutable std::mutex overflowMutex_;
+    std::deque<Job*> overflow_;
+};
 
-    }
-    bool ShouldStart() const override;
+/**
+ * @brief QueueStats is a snapshot of a WorkerQueue, the depth is the number of waiting jobs per priority
+ */
+struct QueueStats
+{
+    std::array<std::size_t, static_cast<std::size_t>(JobPriority::LENGTH)> depth{};
+    std::uint64_t jobsEnqueued = 0;
+    std::uint64_t overflowPushes = 0;
+};
+
+/**
+ * @brief WorkerQueue is the injection queue of a group of workers, with one JobRing per JobPriority.
+ * Jobs are popped by priority, with aging: every AGING_PERIOD pops, a lower priority is served first,
+ * so background work cannot be starved by a constant flow of frame work.
+ */
+class WorkerQueue
+{
+public:
+    static constexpr std::uint32_t AGING_PERIOD = 16;
+    void AddJob(Job* newJob);
+    [[nodiscard]] bool IsEmpty() const;
+    /**
+     * @brief PopNextTask pops the most urgent job whose priority is at least lowestPriority
+     */
+    Job* PopNextTask(JobPriority lowestPriority = JobPriority::BACKGROUND);
+    /**
+     * @brief PopAgedTask pops a job of the aged priorities, from NORMAL to lowestPriority, each in turn.
+     * It is used by the workers for their own aging, as they also pop their local deque.
+     */
+    Job* PopAgedTask(JobPriority lowestPriority = JobPriority::BACKGROUND);
+    [[nodiscard]] QueueStats GetStats() const;
+    /**
+     * @brief ResetStats keeps the current push counts as a baseline, as the ring positions cannot be reset
+     */
+    void ResetStats();
 private:
-    std::weak_ptr<Job> dependency_{};
+    std::array<JobRing, static_cast<std::size_t>(JobPriority::LENGTH)> rings_;
+    /**
+     * @brief popCount_ counts the pops while aged jobs wait, each pop tests the value it incremented
+     */
+    std::atomic<std::uint32_t> popCount_{ 0 };
+    std::atomic<std::uint32_t> agedTurn_{ 0 };
+    std::atomic<std::uint64_t> pushBaseline_{ 0 };
+    std::atomic<std::uint64_t> overflowPushBaseline_{ 0 };
 };
 
-class FuncDependenciesJob: public FuncJob, public DependenciesJob
+/**
+ * @brief WorkerPlacement is the placement policy of the workers of a queue
+ */
+struct WorkerPlacement
 {
-    using DependenciesJob::DependenciesJob;
+    enum class Policy : std::uint8_t
+    {
+        ANY,
+        /**
+         * @brief PINNED_CORES pins each worker to one of the cores, in turn
+         */
+        PINNED_CORES,
+        /**
+         * @brief NUMA_NODE keeps the workers on the cores of the node, the queue storage is also allocated there
+         */
+        NUMA_NODE,
+        /**
+         * @brief AVOID_MAIN_THREAD_CORE pins the calling main thread to its current core and keeps the workers off it
+         */
+        AVOID_MAIN_THREAD_CORE
+    };
+    Policy policy = Policy::ANY;
+    std::vector<int> cores;
+    int numaNode = 0;
 };
 
-class WorkerQueue
+static constexpr auto MAIN_QUEUE_INDEX = -1;
+/**
+ * @brief INVALID_QUEUE_INDEX is returned by SetupNewQueue when the queue could not be created
+ */
+static constexpr auto INVALID_QUEUE_INDEX = -2;
+
+/**
+ * @brief WorkerStats are the statistics of a thread executing jobs, latencies are measured from schedule to start
+ */
+struct WorkerStats
+{
+    std::string name;
+    int queueIndex = MAIN_QUEUE_INDEX;
+    std::uint64_t jobsExecuted = 0;
+    std::uint64_t steals = 0;
+    float busyRatio = 0.0f;
+    float averageLatencyUs = 0.0f;
+    float p50LatencyUs = 0.0f;
+    float p95LatencyUs = 0.0f;
+    float p99LatencyUs = 0.0f;
+};
+
+/**
+ * @brief JobCounters record the statistics of a thread executing jobs. They are only relaxed atomic increments,
+ * cheap enough to stay enabled in release builds. Latencies are kept in a power of two histogram.
+ */
+class JobCounters
 {
 public:
-    WorkerQueue() = default;
-    WorkerQueue(const WorkerQueue&) = delete;
-    WorkerQueue& operator= (const WorkerQueue&) = delete;
-    WorkerQueue(WorkerQueue&&) noexcept{}
-    WorkerQueue& operator= (WorkerQueue&&) noexcept{}
-    void Begin();
-    void AddJob(const std::shared_ptr<Job>& newJob);
-    bool IsEmpty() const;
-    bool IsRunning() const;
-    std::shared_ptr<Job> PopNextTask();
-    void WaitForTask();
-    void End();
+    static constexpr std::size_t LATENCY_BUCKET_COUNT = 32;
+    void AddJob(std::chrono::nanoseconds latency, std::chrono::nanoseconds duration);
+    void AddBusy(std::chrono::nanoseconds duration);
+    void AddIdle(std::chrono::nanoseconds duration);
+    void AddSteal();
+    void Reset();
+    /**
+     * @brief FillStats fills the counters part of the stats, the name and queue index are left untouched
+     */
+    void FillStats(WorkerStats& stats) const;
+    [[nodiscard]] std::uint64_t GetBusyTime() const { return busyNs_.load(std::memory_order_relaxed); }
+    [[nodiscard]] std::uint64_t GetIdleTime() const { return idleNs_.load(std::memory_order_relaxed); }
 private:
-    mutable std::shared_mutex mutex_;
-    std::queue<std::shared_ptr<Job>> jobsQueue_;
-    std::condition_variable_any conditionVariable_;
-    std::atomic<bool> isRunning_{ false };
+    std::atomic<std::uint64_t> jobsExecuted_{ 0 };
+    std::atomic<std::uint64_t> steals_{ 0 };
+    std::atomic<std::uint64_t> busyNs_{ 0 };
+    std::atomic<std::uint64_t> idleNs_{ 0 };
+    std::atomic<std::uint64_t> latencyNs_{ 0 };
+    std::array<std::atomic<std::uint64_t>, LATENCY_BUCKET_COUNT> latencyHistogram_{};
 };
 
 class Worker
 {
 public:
-    Worker(WorkerQueue& queue) : queue_(queue){}
+    Worker(JobSystem& jobSystem, int queueIndex, int workerIndex, std::string_view name, std::vector<int> cores);
     void Begin();
     void End();
+    [[nodiscard]] int GetQueueIndex() const { return queueIndex_; }
+    WorkStealingDeque& GetDeque() { return deque_; }
+    JobCounters& GetCounters() { return counters_; }
+    [[nodiscard]] const JobCounters& GetCounters() const { return counters_; }
+    [[nodiscard]] const std::string& GetName() const { return name_; }
 private:
     void Run();
+    Job* FindJob();
+    std::uint32_t NextRandom();
+
+    JobSystem& jobSystem_;
+    WorkStealingDeque deque_;
+    JobCounters counters_;
     std::thread thread_;
-    WorkerQueue& queue_;
+    std::string name_;
+    std::vector<int> cores_;
+    int queueIndex_ = 0;
+    int workerIndex_ = 0;
+    std::uint32_t randomState_ = 0;
+    /**
+     * @brief popCount_ counts the jobs popped by the worker from its queue or its local deque since its last aged pop
+     */
+    std::uint32_t popCount_ = 0;
 };
 
-static constexpr auto MAIN_QUEUE_INDEX = -1;
+/**
+ * @brief JobSystemStats is a snapshot of the JobSystem statistics since the last reset, e.g. to be displayed with ImGui
+ */
+struct JobSystemStats
+{
+    WorkerStats mainThread;
+    std::vector<WorkerStats> workers;
+    QueueStats mainThreadQueue;
+    std::vector<QueueStats> queues;
+    /**
+     * @brief successorLockContentions counts the times a job successors lock was already taken
+     */
+    std::uint64_t successorLockContentions = 0;
+    JobAllocationCounters allocations;
+};
 
+/**
+ * @brief JobSystem is a work-stealing scheduler. Each worker owns a WorkStealingDeque, each queue has a lock-free
+ * injection WorkerQueue and idle workers steal from random other workers. The queue index given to AddJob is an
+ * affinity hint, apart from MAIN_QUEUE_INDEX that is only ever executed by the main thread.
+ * Only JobPriority::NORMAL jobs go through the worker deques, the others are ordered by their WorkerQueue.
+ * JobPriority::BACKGROUND jobs are never taken by the workers of other queues.
+ */
 class JobSystem
 {
 public:
     JobSystem();
+    ~JobSystem();
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+    static constexpr int MAX_QUEUES = 16;
+    static constexpr int MAX_WORKERS = 64;
     /**
      * @brief SetupNewQueue is a member function that adds a new queue in the JobSystem and
-     * adds a certain number of threads attached to it. It must be called before the Begin member function
+     * adds a certain number of threads attached to it. If called after Begin, the new threads are started immediately.
+     * The threads are named after the queue name and placed following the placement policy.
+     * Returns INVALID_QUEUE_INDEX when there are already MAX_QUEUES queues or no worker left for the new queue.
      */
-    int SetupNewQueue(int threadCount = 1);
+    int SetupNewQueue(int threadCount = 1, const WorkerPlacement& placement = {}, std::string_view name = "Worker");
     /**
      * @brief Begin is a member function that starts the queues and threads of the JobSystem.
      */
     void Begin();
     void AddJob(const std::shared_ptr<Job>& newJob, int queueIndex = MAIN_QUEUE_INDEX);
+    /**
+     * @brief AddJob with a raw pointer does not touch any reference count, the caller keeps the job alive until it is done
+     */
+    void AddJob(Job* newJob, int queueIndex = MAIN_QUEUE_INDEX);
     void End();
+    /**
+     * @brief ExecuteMainThread runs the main thread jobs until all the added ones are done,
+     * helping the workers while waiting for main thread jobs dependencies.
+     * Background main thread jobs are not waited for, they are executed afterward,
+     * and only while the main thread is ahead of the frame deadline and within the background budget.
+     */
     void ExecuteMainThread();
+    /**
+     * @brief SetFrameDeadline starts a new frame for the main thread background budget
+     */
+    void SetFrameDeadline(std::chrono::steady_clock::time_point deadline);
+    /**
+     * @brief SetBackgroundBudget sets the time the main thread can spend on background jobs per frame,
+     * a zero budget means no limit
+     */
+    void SetBackgroundBudget(std::chrono::microseconds budget);
+    /**
+     * @brief TryExecuteWorkerJob lets a thread waiting for worker jobs help by executing one of them.
+     * Returns false if no worker job was available.
+     */
+    bool TryExecuteWorkerJob(JobPriority lowestPriority = JobPriority::BACKGROUND);
+    [[nodiscard]] bool IsRunning() const { return isRunning_.load(std::memory_order_acquire); }
+    [[nodiscard]] int GetQueueCount() const { return queueCount_.load(std::memory_order_acquire); }
+    [[nodiscard]] int GetWorkerCount() const { return workerCount_.load(std::memory_order_acquire); }
+    /**
+     * @brief GetQueueWorkerCount returns the number of workers attached to the queue, zero for an invalid queue index
+     */
+    [[nodiscard]] int GetQueueWorkerCount(int queueIndex) const;
+    [[nodiscard]] JobSystemStats GetStats() const;
+    void ResetStats();
+    /**
+     * @brief PlotStats sends the queues depth and the threads busy ratio since the last call to Tracy plots
+     */
+    void PlotStats();
 private:
+    friend class Worker;
+    friend class Job;
+    friend class JobGraph;
+    friend class CoroutineJob;
+    /**
+     * @brief Submit registers an already reset job to its dependencies and schedules it if they are all done
+     */
+    void Submit(Job* job, int queueIndex);
+    void Schedule(Job* job);
+    /**
+     * @brief ReleaseUnexecutedJob gives back a job that will never be executed, to its pool or by dropping its keepAlive_
+     */
+    static void ReleaseUnexecutedJob(Job* job);
+    /**
+     * @brief TrackWaitingJob records a shared job added with dependencies, so End can release it if it is still waiting
+     */
+    void TrackWaitingJob(const std::shared_ptr<Job>& job);
+    /**
+     * @brief WakeWorkers wakes a sleeping worker for a job added on the queue, preferably one of the queue.
+     * The other queues are only woken when the queue has no sleeping worker and the job is not a background one,
+     * as background jobs are only taken by the workers of their queue.
+     */
+    void WakeWorkers(int queueIndex, JobPriority priority);
+    void ExecuteJob(Job* job);
+    /**
+     * @brief GetCurrentCounters returns the counters of the calling worker, or of the main thread for other threads
+     */
+    JobCounters& GetCurrentCounters();
+    void CreateQueue(int queueIndex, int threadCount, const WorkerPlacement& placement, std::string_view name);
+    void AddPendingMainJob(Job* job);
+    void ReleasePendingMainJob(Job* job);
+    [[nodiscard]] bool CanExecuteBackground() const;
+    void ExecuteBackground(Job* job);
+
     WorkerQueue mainThreadQueue_{};
-    std::vector<WorkerQueue> queues_{};
-    std::vector<Worker> workers_{};
+    std::array<std::unique_ptr<WorkerQueue>, MAX_QUEUES> queues_{};
+    std::array<std::unique_ptr<Worker>, MAX_WORKERS> workers_{};
+    std::atomic<int> queueCount_{ 0 };
+    std::atomic<int> workerCount_{ 0 };
+    std::array<std::atomic<int>, MAX_QUEUES> queueWorkerCounts_{};
+    std::atomic<bool> isRunning_{ false };
+    /**
+     * @brief hasEnded_ is set by End once the workers are stopped, the jobs scheduled afterward are released instead
+     */
+    std::atomic<bool> hasEnded_{ false };
+    std::mutex waitingJobsMutex_;
+    std::vector<std::weak_ptr<Job>> waitingJobs_;
+    std::size_t waitingJobsPruneSize_ = 0;
+    /**
+     * @brief QueueWakeup is where the idle workers of a queue sleep. The epoch is incremented each time a job they can
+     * take is pushed, and they wait on it to be changed.
+     */
+    struct alignas(64) QueueWakeup
+    {
+        std::atomic<std::uint32_t> workEpoch{ 0 };
+        std::atomic<int> sleepingWorkers{ 0 };
+    };
+    std::array<QueueWakeup, MAX_QUEUES> queueWakeups_{};
+    std::atomic<int> pendingMainJobs_{ 0 };
+    /**
+     * @brief mainEpoch_ is incremented each time a main thread job is scheduled, the main thread waits on it
+     */
+    std::atomic<std::uint32_t> mainEpoch_{ 0 };
+    std::chrono::steady_clock::time_point frameDeadline_ = std::chrono::steady_clock::time_point::max();
+    std::chrono::microseconds backgroundBudget_{ 0 };
+    std::chrono::steady_clock::duration backgroundTime_{ 0 };
+    int mainThreadCore_ = -1;
+    JobCounters mainThreadCounters_;
+    struct PlotSample
+    {
+        std::uint64_t busyNs = 0;
+        std::uint64_t idleNs = 0;
+    };
+    std::array<PlotSample, MAX_WORKERS + 1> plotSamples_{};
+    /**
+     * @brief allocationBaseline_ is subtracted from the cumulative job allocation counters in the stats
+     */
+    JobAllocationCounters allocationBaseline_{};
+    std::array<std::string, MAX_QUEUES> queuePlotNames_{};
 };
 
 JobSystem* GetJobSystem();
-}
\ No newline at end of file
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "utils/job_system.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+namespace core
+{
+
+/**
+ * @brief ParallelForChunks splits [begin, end) in chunks of grain elements executed by the JobSystem workers.
+ * The calling thread executes chunks too and returns when all of them are done, with at most 16 helper jobs.
+ * Jobs are added on the queue index, but the workers of any queue can steal them.
+ * The default queue index 0 is the first queue created, the frame worker queue when Engine::Begin sets up the JobSystem.
+ * It runs on the calling thread when there is a single chunk, when the queue has no worker,
+ * or for a negative queue index, as waiting on the main thread queue from the main thread would never return.
+ */
+void ParallelForChunks(std::size_t begin, std::size_t end, std::size_t grain,
+    void (*func)(void* context, std::size_t chunkBegin, std::size_t chunkEnd),
+    void* context, int queueIndex = 0);
+
+/**
+ * @brief ParallelFor calls func(index) for every index in [begin, end)
+ */
+template<typename Func>
+void ParallelFor(std::size_t begin, std::size_t end, std::size_t grain, Func&& func, int queueIndex = 0)
+{
+    using FuncType = std::remove_reference_t<Func>;
+    ParallelForChunks(begin, end, grain, [](void* context, std::size_t chunkBegin, std::size_t chunkEnd)
+    {
+        auto& chunkFunc = *static_cast<FuncType*>(context);
+        for (std::size_t i = chunkBegin; i < chunkEnd; i++)
+        {
+            chunkFunc(i);
+        }
+    }, const_cast<std::remove_const_t<FuncType>*>(&func), queueIndex);
+}
+
+/**
+ * @brief ParallelForRange calls func(chunkBegin, chunkEnd) for every chunk of [begin, end),
+ * useful for kernels working on contiguous data
+ */
+template<typename Func>
+void ParallelForRange(std::size_t begin, std::size_t end, std::size_t grain, Func&& func, int queueIndex = 0)
+{
+    using FuncType = std::remove_reference_t<Func>;
+    ParallelForChunks(begin, end, grain, [](void* context, std::size_t chunkBegin, std::size_t chunkEnd)
+    {
+        (*static_cast<FuncType*>(context))(chunkBegin, chunkEnd);
+    }, const_cast<std::remove_const_t<FuncType>*>(&func), queueIndex);
+}
+
+/**
+ * @brief ParallelReduce maps every index of [begin, end) and reduces them, starting each chunk from identity.
+ * Chunks results are reduced in order, so the result is deterministic for a given grain.
+ */
+template<typename T, typename MapFunc, typename ReduceFunc>
+T ParallelReduce(std::size_t begin, std::size_t end, std::size_t grain, T identity,
+    MapFunc&& map, ReduceFunc&& reduce, int queueIndex = 0)
+{
+    if (end <= begin)
+    {
+        return identity;
+    }
+    grain = std::max<std::size_t>(grain, 1);
+    const auto chunkCount = (end - begin + grain - 1) / grain;
+    std::vector<T> chunkResults(chunkCount, identity);
+    ParallelForRange(begin, end, grain, [&](std::size_t chunkBegin, std::size_t chunkEnd)
+    {
+        T result = identity;
+        for (std::size_t i = chunkBegin; i < chunkEnd; i++)
+        {
+            result = reduce(result, map(i));
+        }
+        chunkResults[(chunkBegin - begin) / grain] = result;
+    }, queueIndex);
+    T result = identity;
+    for (const auto& chunkResult : chunkResults)
+    {
+        result = reduce(result, chunkResult);
+    }
+    return result;
+}
+
+/**
+ * @brief ParallelSort sorts chunks of grain elements in parallel, then merges them pairwise in parallel
+ */
+template<std::random_access_iterator It, typename Compare = std::less<>>
+void ParallelSort(It first, It last, std::size_t grain, Compare comp = {}, int queueIndex = 0)
+{
+    const auto count = static_cast<std::size_t>(std::distance(first, last));
+    grain = std::max<std::size_t>(grain, 1);
+    if (count <= grain)
+    {
+        std::sort(first, last, comp);
+        return;
+    }
+    const auto chunkCount = (count + grain - 1) / grain;
+    ParallelFor(0, chunkCount, 1, [&](std::size_t chunk)
+    {
+        const auto chunkBegin = chunk * grain;
+        const auto chunkEnd = std::min(count, chunkBegin + grain);
+        std::sort(first + chunkBegin, first + chunkEnd, comp);
+    }, queueIndex);
+    for (std::size_t width = grain; width < count; width *= 2)
+    {
+        const auto mergeCount = (count + 2 * width - 1) / (2 * width);
+        ParallelFor(0, mergeCount, 1, [&](std::size_t merge)
+        {
+            const auto mergeBegin = merge * 2 * width;
+            const auto mergeMiddle = std::min(count, mergeBegin + width);
+            const auto mergeEnd = std::min(count, mergeBegin + 2 * width);
+            std::inplace_merge(first + mergeBegin, first + mergeMiddle, first + mergeEnd, comp);
+        }, queueIndex);
+    }
+}
+
+} // namespace core
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace core
+{
+
+/**
+ * @brief SetCurrentThreadName gives an OS-visible name to the calling thread, also forwarded to Tracy
+ */
+void SetCurrentThreadName(std::string_view name);
+/**
+ * @brief SetCurrentThreadAffinity restricts the calling thread to the given cores, returns false if it failed
+ * or if the platform does not support it
+ */
+bool SetCurrentThreadAffinity(std::span<const int> cores);
+/**
+ * @brief GetNumaNodeCores returns the cores of a NUMA node, empty if the node or the platform support is missing
+ */
+std::vector<int> GetNumaNodeCores(int numaNode);
+/**
+ * @brief GetCurrentCore returns the core the calling thread is running on, or -1 if unknown
+ */
+int GetCurrentCore();
+int GetCoreCount();
+
+} // namespace core
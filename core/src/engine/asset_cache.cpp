@@ -0,0 +1,273 @@
+#include "engine/asset_cache.h"
+#include "utils/hash.h"
+#include "utils/log.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#ifdef TRACY_ENABLE
+#include <tracy/Tracy.hpp>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace core
+{
+
+namespace
+{
+constexpr std::string_view ASSET_CACHE_EXTENSION = ".ddc";
+}
+
+AssetCacheKey MakeAssetCacheKey(std::span<const unsigned char> content, std::string_view importSettings)
+{
+    return { HashBytes(content.data(), content.size()), HashString(importSettings) };
+}
+
+bool AssetCache::Open(std::string_view directory, std::size_t maxSize)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    std::scoped_lock lock(mutex_);
+    std::error_code error;
+    fs::create_directories(directory, error);
+    if (error)
+    {
+        LogError(fmt::format("Could not create asset cache directory: {}, {}", directory, error.message()));
+        return false;
+    }
+    directory_ = directory;
+    entries_.clear();
+    stats_ = {};
+    stats_.maxSize = maxSize;
+    // the least recently used entries were written or read first, the reads touch the entry files
+    std::vector<std::pair<fs::file_time_type, std::string>> entryTimes;
+    for (const auto& directoryEntry : fs::directory_iterator(directory_, error))
+    {
+        if (!directoryEntry.is_regular_file() || directoryEntry.path().extension() != ASSET_CACHE_EXTENSION)
+        {
+            continue;
+        }
+        auto entryName = directoryEntry.path().filename().string();
+        entries_[entryName].size = static_cast<std::size_t>(directoryEntry.file_size());
+        stats_.size += entries_[entryName].size;
+        entryTimes.emplace_back(directoryEntry.last_write_time(), std::move(entryName));
+    }
+    std::ranges::sort(entryTimes);
+    useCounter_ = 0;
+    for (const auto& [time, entryName] : entryTimes)
+    {
+        entries_[entryName].lastUse = ++useCounter_;
+    }
+    EvictOverSize();
+    return true;
+}
+
+void AssetCache::Close()
+{
+    std::scoped_lock lock(mutex_);
+    directory_.clear();
+    entries_.clear();
+}
+
+bool AssetCache::IsOpen() const
+{
+    std::scoped_lock lock(mutex_);
+    return !directory_.empty();
+}
+
+FileBuffer AssetCache::Load(const AssetCacheKey& key)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    const auto entryName = GetEntryName(key);
+    std::string entryPath;
+    {
+        std::scoped_lock lock(mutex_);
+        if (directory_.empty())
+        {
+            return {};
+        }
+        if (!entries_.contains(entryName))
+        {
+            stats_.misses++;
+            return {};
+        }
+        entryPath = GetEntryPath(entryName);
+    }
+    std::error_code error;
+    const auto entrySize = static_cast<std::uint64_t>(fs::file_size(entryPath, error));
+    std::ifstream file(entryPath, std::ios::binary);
+    AssetCacheEntryHeader header{};
+    FileBuffer fileBuffer;
+    // the size of the data is checked against the entry file before trusting it for the allocation
+    if (!error && file.read(reinterpret_cast<char*>(&header), sizeof(header)) && header.magic == ASSET_CACHE_MAGIC &&
+        header.version == ASSET_CACHE_VERSION && header.contentHash == key.contentHash &&
+        header.settingsHash == key.settingsHash && header.size == entrySize - sizeof(header))
+    {
+        fileBuffer.data = static_cast<unsigned char*>(std::malloc(header.size + 1));
+        if (fileBuffer.data == nullptr)
+        {
+            LogError(fmt::format("Could not allocate {} bytes to load asset cache entry: {}", header.size + 1, entryPath));
+            return {};
+        }
+        fileBuffer.data[header.size] = 0;
+        fileBuffer.size = header.size;
+        if (!file.read(reinterpret_cast<char*>(fileBuffer.data), static_cast<std::streamsize>(header.size)) ||
+            HashBytes(fileBuffer.data, fileBuffer.size) != header.dataHash)
+        {
+            fileBuffer = {};
+        }
+    }
+    file.close();
+
+    std::scoped_lock lock(mutex_);
+    if (fileBuffer.data == nullptr)
+    {
+        LogWarning(fmt::format("Removing corrupted asset cache entry: {}", entryPath));
+        Remove(entryName);
+        stats_.misses++;
+        return {};
+    }
+    stats_.hits++;
+    if (const auto it = entries_.find(entryName); it != entries_.end())
+    {
+        it->second.lastUse = ++useCounter_;
+    }
+    fs::last_write_time(entryPath, fs::file_time_type::clock::now(), error);
+    return fileBuffer;
+}
+
+void AssetCache::Store(const AssetCacheKey& key, std::span<const unsigned char> data)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    const auto entryName = GetEntryName(key);
+    std::string entryPath;
+    {
+        std::scoped_lock lock(mutex_);
+        if (directory_.empty())
+        {
+            return;
+        }
+        entryPath = GetEntryPath(entryName);
+    }
+    AssetCacheEntryHeader header{};
+    header.magic = ASSET_CACHE_MAGIC;
+    header.version = ASSET_CACHE_VERSION;
+    header.contentHash = key.contentHash;
+    header.settingsHash = key.settingsHash;
+    header.size = data.size();
+    header.dataHash = HashBytes(data.data(), data.size());
+    // written next to the entry and renamed, a reader never sees a partial entry
+    const auto temporaryPath = fmt::format("{}.{}.tmp", entryPath, std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    {
+        std::ofstream file(temporaryPath, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!file)
+        {
+            LogError(fmt::format("Could not write asset cache entry: {}", entryPath));
+            return;
+        }
+    }
+    std::error_code error;
+    fs::rename(temporaryPath, entryPath, error);
+    if (error)
+    {
+        LogError(fmt::format("Could not write asset cache entry: {}, {}", entryPath, error.message()));
+        fs::remove(temporaryPath, error);
+        return;
+    }
+
+    std::scoped_lock lock(mutex_);
+    auto& entry = entries_[entryName];
+    stats_.size -= entry.size;
+    entry.size = sizeof(header) + data.size();
+    entry.lastUse = ++useCounter_;
+    stats_.size += entry.size;
+    stats_.stores++;
+    EvictOverSize();
+}
+
+void AssetCache::SetMaxSize(std::size_t maxSize)
+{
+    std::scoped_lock lock(mutex_);
+    stats_.maxSize = maxSize;
+    EvictOverSize();
+}
+
+AssetCacheStats AssetCache::GetStats() const
+{
+    std::scoped_lock lock(mutex_);
+    auto stats = stats_;
+    stats.entryCount = entries_.size();
+    return stats;
+}
+
+void AssetCache::ResetStats()
+{
+    std::scoped_lock lock(mutex_);
+    stats_.hits = 0;
+    stats_.misses = 0;
+    stats_.stores = 0;
+    stats_.evictions = 0;
+}
+
+std::string AssetCache::GetEntryName(const AssetCacheKey& key)
+{
+    return fmt::format("{:016x}{:016x}{}", key.contentHash, key.settingsHash, ASSET_CACHE_EXTENSION);
+}
+
+std::string AssetCache::GetEntryPath(std::string_view entryName) const
+{
+    return fmt::format("{}/{}", directory_, entryName);
+}
+
+void AssetCache::Remove(const std::string& entryName)
+{
+    const auto it = entries_.find(entryName);
+    if (it == entries_.end())
+    {
+        return;
+    }
+    stats_.size -= it->second.size;
+    entries_.erase(it);
+    std::error_code error;
+    fs::remove(GetEntryPath(entryName), error);
+}
+
+void AssetCache::EvictOverSize()
+{
+    if (stats_.size <= stats_.maxSize)
+    {
+        return;
+    }
+    std::vector<std::pair<std::uint64_t, std::string>> entriesByUse;
+    entriesByUse.reserve(entries_.size());
+    for (const auto& [entryName, entry] : entries_)
+    {
+        entriesByUse.emplace_back(entry.lastUse, entryName);
+    }
+    std::ranges::sort(entriesByUse);
+    for (const auto& [lastUse, entryName] : entriesByUse)
+    {
+        if (stats_.size <= stats_.maxSize)
+        {
+            break;
+        }
+        Remove(entryName);
+        stats_.evictions++;
+    }
+}
+
+} // namespace core
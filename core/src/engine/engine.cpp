@@ -4,11 +4,13 @@
 #include "engine/filesystem.h"
 
 
+#include <algorithm>
 #include <chrono>
 #include <cassert>
 #include <imgui_impl_sdl2.h>
 #include <glm/vec2.hpp>
 
+#include "utils/job_pool.h"
 #include "utils/log.h"
 
 #include <fmt/format.h>
@@ -29,11 +31,40 @@ ModelManager& Engine::GetModelManager()
     return modelManager_;
 }
 
+AssetCache& Engine::GetAssetCache()
+{
+    return assetCache_;
+}
+
 void Engine::Begin()
 {
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
+    // the general worker queue is the first one, used by the systems updates and the parallel algorithms
+    // the frame workers leave room for the file I/O workers, which would get none on machines with many cores
+    const int workerCount = std::clamp(static_cast<int>(std::thread::hardware_concurrency()) - 1, 1,
+        JobSystem::MAX_WORKERS - FILE_IO_THREAD_COUNT - 1);
+    workerQueue_ = jobSystem_.SetupNewQueue(workerCount, {}, "Frame Worker");
+    if (workerQueue_ == INVALID_QUEUE_INDEX)
+    {
+        LogError("Could not create the frame worker queue, the systems are updated on the main thread");
+        workerQueue_ = MAIN_QUEUE_INDEX;
+    }
+    // the file I/O threads mostly wait on the disk, more of them keep more reads in flight
+    const auto ioQueue = jobSystem_.SetupNewQueue(FILE_IO_THREAD_COUNT, {}, "File IO");
+    if (ioQueue == INVALID_QUEUE_INDEX)
+    {
+        LogError("Could not create the file I/O queue, the files are loaded synchronously");
+    }
+    FilesystemLocator::get().SetIoQueue(ioQueue == INVALID_QUEUE_INDEX ? MAIN_QUEUE_INDEX : ioQueue);
+    jobSystem_.SetBackgroundBudget(std::chrono::microseconds(config_.background_budget_us()));
+    const auto assetCacheSize = config_.asset_cache_size_mb() > 0 ?
+        static_cast<std::size_t>(config_.asset_cache_size_mb()) * 1024 * 1024 : AssetCache::DEFAULT_MAX_SIZE;
+    if (assetCache_.Open(ASSET_CACHE_DIRECTORY, assetCacheSize))
+    {
+        modelManager_.SetAssetCache(&assetCache_);
+    }
     jobSystem_.Begin();
     for(auto* system: systems_)
     {
@@ -98,12 +129,8 @@ void Engine::Run()
     });
     using seconds = std::chrono::duration<float, std::ratio<1,1>>;
     seconds dt;
-    jobs_[(int)JobIndex::UPDATE]  = std::make_shared<FuncDependentJob>(jobs_[(int)JobIndex::PRE_UPDATE], [this, &dt](){
-        for(auto* system : systems_)
-        {
-            system->Update(dt.count());
-        }
-    });
+    // UPDATE is done when all the systems update jobs are done
+    jobs_[(int)JobIndex::UPDATE]  = std::make_shared<FuncDependentJob>(jobs_[(int)JobIndex::PRE_UPDATE], [](){});
 
     jobs_[(int)JobIndex::PRE_IMGUI] = std::make_shared<FuncDependentJob>(jobs_[(int)JobIndex::UPDATE], [this](){
         //Generate new ImGui frame
@@ -125,6 +152,42 @@ void Engine::Run()
        SwapWindow();
     });
 
+    // the frame graph is compiled once and replayed every frame
+    frameGraph_.Clear();
+    for(auto& job: jobs_)
+    {
+        job->SetPriority(JobPriority::FRAME);
+        frameGraph_.AddJob(job.get());
+    }
+    // each system update is a job, depending on the previous systems it conflicts with
+    systemUpdateJobs_.clear();
+    std::vector<SystemAccess> systemAccesses;
+    systemAccesses.reserve(systems_.size());
+    for(auto* system : systems_)
+    {
+        const auto access = system->GetAccess();
+        auto& updateJob = systemUpdateJobs_.emplace_back(std::make_unique<InlineFuncJob<>>([system, &dt](){
+#ifdef TRACY_ENABLE
+            ZoneScopedN("System Update");
+#endif
+            SystemAccessScope accessScope(system);
+            system->Update(dt.count());
+        }));
+        updateJob->SetPriority(JobPriority::FRAME);
+        frameGraph_.AddJob(updateJob.get(), access.mainThread ? MAIN_QUEUE_INDEX : workerQueue_);
+        frameGraph_.AddDependency(updateJob.get(), jobs_[(int)JobIndex::PRE_UPDATE].get());
+        for(std::size_t i = 0; i < systemAccesses.size(); i++)
+        {
+            if(access.ConflictsWith(systemAccesses[i]))
+            {
+                frameGraph_.AddDependency(updateJob.get(), systemUpdateJobs_[i].get());
+            }
+        }
+        frameGraph_.AddDependency(jobs_[(int)JobIndex::UPDATE].get(), updateJob.get());
+        systemAccesses.push_back(access);
+    }
+    frameGraph_.Compile();
+
     std::chrono::time_point<std::chrono::system_clock> clock = std::chrono::system_clock::now();
     while(isOpen)
     {
@@ -135,13 +198,16 @@ void Engine::Run()
 
         dt = std::chrono::duration_cast<seconds>(start - clock);
         clock = start;
+        // without a framerate limit, the main thread executes the background jobs within its budget only
+        const auto frameDeadline = config_.framerate_limit() > 0 ?
+            std::chrono::steady_clock::now() + std::chrono::microseconds(1'000'000 / config_.framerate_limit()) :
+            std::chrono::steady_clock::time_point::max();
+        jobSystem_.SetFrameDeadline(frameDeadline);
 
-        for(auto& job: jobs_)
-        {
-            jobSystem_.AddJob(job);
-        }
+        frameGraph_.Run(jobSystem_);
         jobSystem_.ExecuteMainThread();
 #ifdef TRACY_ENABLE
+        jobSystem_.PlotStats();
         FrameMark;
 #endif
     }
@@ -160,8 +226,13 @@ void Engine::End()
     }
 
     jobSystem_.End();
+    assetCache_.Close();
     const auto& fileSystem = FilesystemLocator::get();
-    fileSystem.WriteString(Path(configFilename), config_.SerializeAsString());
+    // the players run from a read-only pack, they keep the config they were shipped with
+    if (!fileSystem.IsReadOnly())
+    {
+        fileSystem.WriteString(Path(configFilename), config_.SerializeAsString());
+    }
 
 }
 
@@ -236,14 +307,21 @@ glm::uvec2 GetWindowSize()
 }
 TextureManager& GetTextureManager()
 {
+    ValidateSystemAccess(SystemResource::TEXTURES);
     return instance->GetTextureManager();
 }
 
 ModelManager& GetModelManager()
 {
+    ValidateSystemAccess(SystemResource::MODELS);
     return instance->GetModelManager();
 }
 
+AssetCache& GetAssetCache()
+{
+    return instance->GetAssetCache();
+}
+
 void SetWindowName(std::string_view windowName)
 {
     instance->SetWindowName(windowName);
@@ -1,9 +1,19 @@
 #include "engine/filesystem.h"
 #include "utils/log.h"
 #include <fmt/format.h>
+#include <algorithm>
 #include <fstream>
 #include <filesystem>
 
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #ifdef TRACY_ENABLE
 #include <tracy/Tracy.hpp>
 #endif
@@ -16,12 +26,149 @@ namespace core
 
 FileBuffer::~FileBuffer()
 {
-    if(data != nullptr)
+    if(data == nullptr)
+    {
+        return;
+    }
+    switch (storage_)
     {
+    case Storage::MAPPED:
+#if defined(_WIN32)
+        UnmapViewOfFile(data);
+#else
+        munmap(data, GetMappedSize(size));
+#endif
+        break;
+    case Storage::HEAP:
         std::free(data);
-        data = nullptr;
-        size = 0;
+        break;
+    default:
+        break;
+    }
+    data = nullptr;
+    size = 0;
+}
+
+std::size_t FileBuffer::GetPageSize()
+{
+#if defined(_WIN32)
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    return systemInfo.dwPageSize;
+#else
+    return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+std::size_t FileBuffer::GetMappedSize(std::size_t fileSize)
+{
+#if defined(_WIN32)
+    return fileSize;
+#else
+    // a file filling its last page is mapped with an extra zero page
+    return fileSize % GetPageSize() == 0 ? fileSize + GetPageSize() : fileSize;
+#endif
+}
+
+FileBuffer FileBuffer::View(unsigned char* data, std::size_t size)
+{
+    FileBuffer fileBuffer;
+    fileBuffer.data = data;
+    fileBuffer.size = size;
+    fileBuffer.storage_ = Storage::VIEW;
+    return fileBuffer;
+}
+
+FileBuffer FileBuffer::Map(std::string_view path, FileAccessHint hint)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    FileBuffer fileBuffer;
+    const std::string pathString(path);
+#if defined(_WIN32)
+    const DWORD flags = hint == FileAccessHint::SEQUENTIAL ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL;
+    const HANDLE file = CreateFileA(pathString.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, flags, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return fileBuffer;
+    }
+    LARGE_INTEGER fileSize{};
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return fileBuffer;
+    }
+    const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr)
+    {
+        return fileBuffer;
+    }
+    // the view keeps the mapping alive
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (view == nullptr)
+    {
+        return fileBuffer;
+    }
+    const auto size = static_cast<std::size_t>(fileSize.QuadPart);
+    if (hint == FileAccessHint::WILL_NEED)
+    {
+        WIN32_MEMORY_RANGE_ENTRY range{ view, size };
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    }
+#else
+    const int file = open(pathString.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        return fileBuffer;
+    }
+    struct stat fileStat{};
+    if (fstat(file, &fileStat) != 0 || fileStat.st_size == 0)
+    {
+        close(file);
+        return fileBuffer;
+    }
+    const auto size = static_cast<std::size_t>(fileStat.st_size);
+    const auto mappedSize = GetMappedSize(size);
+    void* view = MAP_FAILED;
+    if (mappedSize == size)
+    {
+        view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+    }
+    else
+    {
+        // the file is mapped over the start of a zero anonymous mapping, keeping its data null-terminated
+        view = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (view != MAP_FAILED && mmap(view, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, file, 0) == MAP_FAILED)
+        {
+            munmap(view, mappedSize);
+            view = MAP_FAILED;
+        }
+    }
+    // the mapping stays valid after closing the file
+    close(file);
+    if (view == MAP_FAILED)
+    {
+        return fileBuffer;
     }
+    switch (hint)
+    {
+    case FileAccessHint::SEQUENTIAL:
+        madvise(view, size, MADV_SEQUENTIAL);
+        break;
+    case FileAccessHint::WILL_NEED:
+        madvise(view, size, MADV_WILLNEED);
+        break;
+    default:
+        break;
+    }
+#endif
+    fileBuffer.data = static_cast<unsigned char*>(view);
+    fileBuffer.size = size;
+    fileBuffer.storage_ = Storage::MAPPED;
+    return fileBuffer;
 }
 
 FileBuffer DefaultFilesystem::LoadFile(const Path &path) const
@@ -35,6 +182,15 @@ FileBuffer DefaultFilesystem::LoadFile(const Path &path) const
     {
         return bufferFile;
     }
+    if (CanMemoryMap(GetFileSize(path)))
+    {
+        bufferFile = FileBuffer::Map(path);
+        if (bufferFile.data != nullptr)
+        {
+            return bufferFile;
+        }
+        LogWarning(fmt::format("Could not memory map file: {}", path.c_str()));
+    }
     const std::ifstream file(path.c_str(), std::ifstream::binary);
     // get pointer to associated buffer object
     std::filebuf* pbuf = file.rdbuf();
@@ -44,7 +200,11 @@ FileBuffer DefaultFilesystem::LoadFile(const Path &path) const
     pbuf->pubseekpos(0, std::ifstream::in);
 
     bufferFile.data = static_cast<unsigned char*>(std::malloc(size + 1));
-    
+    if (bufferFile.data == nullptr)
+    {
+        LogError(fmt::format("Could not allocate {} bytes to load file: {}", size + 1, path.c_str()));
+        return bufferFile;
+    }
 
     // get file data
     pbuf->sgetn(reinterpret_cast<char*>(bufferFile.data), size);
@@ -53,6 +213,124 @@ FileBuffer DefaultFilesystem::LoadFile(const Path &path) const
     return bufferFile;
 }
 
+FileBuffer DefaultFilesystem::LoadFileStreamed(const Path &path, std::size_t chunkSize, const FileLoadProgress& onProgress) const
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    const auto fileSize = GetFileSize(path);
+    // a mapping is paged in on access, there is nothing to stream
+    if (fileSize == 0 || CanMemoryMap(fileSize))
+    {
+        return LoadFile(path);
+    }
+    std::ifstream file(path.c_str(), std::ifstream::binary);
+    if (!file)
+    {
+        LogError(fmt::format("Could not open file: {}", path.c_str()));
+        return {};
+    }
+    FileBuffer bufferFile;
+    bufferFile.data = static_cast<unsigned char*>(std::malloc(fileSize + 1));
+    if (bufferFile.data == nullptr)
+    {
+        LogError(fmt::format("Could not allocate {} bytes to load file: {}", fileSize + 1, path.c_str()));
+        return bufferFile;
+    }
+    bufferFile.size = fileSize;
+    std::size_t loadedSize = 0;
+    while (loadedSize < fileSize)
+    {
+        const auto readSize = std::min(chunkSize, fileSize - loadedSize);
+        if (!file.read(reinterpret_cast<char*>(bufferFile.data + loadedSize), static_cast<std::streamsize>(readSize)))
+        {
+            LogError(fmt::format("Could not read file: {}", path.c_str()));
+            bufferFile.size = loadedSize + static_cast<std::size_t>(file.gcount());
+            break;
+        }
+        loadedSize += readSize;
+        if (loadedSize < fileSize && onProgress)
+        {
+            onProgress(bufferFile.data, loadedSize);
+        }
+    }
+    bufferFile.data[bufferFile.size] = 0;
+    return bufferFile;
+}
+
+std::size_t DefaultFilesystem::GetFileSize(const Path &path) const
+{
+    std::error_code error;
+    const auto fileSize = fs::file_size(path.c_str(), error);
+    return error ? 0 : static_cast<std::size_t>(fileSize);
+}
+
+bool DefaultFilesystem::CanMemoryMap(std::size_t fileSize) const
+{
+    if (!allowMemoryMapping_ || fileSize < MEMORY_MAP_THRESHOLD)
+    {
+        return false;
+    }
+#if defined(_WIN32)
+    // a view cannot be followed by a zero page, a file filling its last page would not be null-terminated
+    return fileSize % FileBuffer::GetPageSize() != 0;
+#else
+    return true;
+#endif
+}
+
+FileLoadJob::FileLoadJob(const FilesystemInterface& filesystem, const Path& path) :
+    filesystem_(filesystem), path_(path)
+{
+    SetPriority(JobPriority::BACKGROUND);
+}
+
+void FileLoadJob::ExecuteImpl()
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+    ZoneText(path_.c_str(), path_.size());
+#endif
+    fileBuffer_ = filesystem_.LoadFile(path_);
+}
+
+std::shared_ptr<FileLoadJob> FilesystemInterface::LoadFileAsync(const Path& path) const
+{
+    auto fileLoadJob = std::make_shared<FileLoadJob>(*this, path);
+    auto* jobSystem = GetJobSystem();
+    if (ioQueue_ == MAIN_QUEUE_INDEX || jobSystem == nullptr || !jobSystem->IsRunning())
+    {
+        fileLoadJob->Execute();
+        return fileLoadJob;
+    }
+    jobSystem->AddJob(fileLoadJob, ioQueue_);
+    return fileLoadJob;
+}
+
+FileLoadBatch FilesystemInterface::LoadFilesAsync(std::span<const Path> paths) const
+{
+    FileLoadBatch batch;
+    batch.fileLoadJobs.reserve(paths.size());
+    auto completionJob = std::make_shared<FuncJob>([](){});
+    for (const auto& path : paths)
+    {
+        auto& fileLoadJob = batch.fileLoadJobs.emplace_back(LoadFileAsync(path));
+        completionJob->AddDependency(fileLoadJob.get());
+    }
+    auto* jobSystem = GetJobSystem();
+    if (ioQueue_ == MAIN_QUEUE_INDEX || jobSystem == nullptr || !jobSystem->IsRunning())
+    {
+        completionJob->Execute();
+    }
+    else
+    {
+        completionJob->SetPriority(JobPriority::BACKGROUND);
+        jobSystem->AddJob(completionJob, ioQueue_);
+    }
+    batch.completionJob = std::move(completionJob);
+    return batch;
+}
+
 bool DefaultFilesystem::FileExists(const Path &path) const
 {
     return fs::exists(path.c_str());
@@ -69,8 +347,51 @@ bool DefaultFilesystem::IsDirectory(const Path &path) const
 }
 void DefaultFilesystem::WriteString(const Path &path, std::string_view content) const
 {
-    std::ofstream outFile(path.c_str(), std::ofstream::binary);
-    outFile << content;
+    // the file is replaced instead of rewritten in place, so its current mappings keep the previous content
+    const auto tmpPath = fmt::format("{}.tmp", path.c_str());
+    {
+        std::ofstream outFile(tmpPath, std::ofstream::binary);
+        if (!(outFile << content))
+        {
+            LogError(fmt::format("Could not write file: {}", path.c_str()));
+            return;
+        }
+    }
+    std::error_code error;
+    fs::rename(tmpPath, path.c_str(), error);
+    if (error)
+    {
+        LogError(fmt::format("Could not replace file: {}, {}", path.c_str(), error.message()));
+        fs::remove(tmpPath, error);
+    }
+}
+
+FileId DefaultFilesystem::GetFileId(const Path &path) const
+{
+#if defined(_WIN32)
+    const HANDLE file = CreateFileA(path.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return INVALID_FILE_ID;
+    }
+    BY_HANDLE_FILE_INFORMATION fileInformation{};
+    const bool hasInformation = GetFileInformationByHandle(file, &fileInformation);
+    CloseHandle(file);
+    if (!hasInformation)
+    {
+        return INVALID_FILE_ID;
+    }
+    return { fileInformation.dwVolumeSerialNumber,
+        (static_cast<std::uint64_t>(fileInformation.nFileIndexHigh) << 32u) | fileInformation.nFileIndexLow };
+#else
+    struct stat fileStat{};
+    if (stat(path.c_str(), &fileStat) != 0)
+    {
+        return INVALID_FILE_ID;
+    }
+    return { static_cast<std::uint64_t>(fileStat.st_dev), static_cast<std::uint64_t>(fileStat.st_ino) };
+#endif
 }
 
 bool IOSystem::Exists(const char* pFile) const
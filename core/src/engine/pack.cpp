@@ -0,0 +1,621 @@
+#include "engine/pack.h"
+#include "utils/hash.h"
+#include "utils/log.h"
+#include "utils/parallel.h"
+
+#include <fmt/format.h>
+#include <zstd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <unordered_map>
+
+#ifdef TRACY_ENABLE
+#include <tracy/Tracy.hpp>
+#endif
+
+namespace core
+{
+
+namespace
+{
+constexpr int PACK_COMPRESSION_LEVEL = 3;
+
+constexpr std::uint64_t AlignPackOffset(std::uint64_t offset)
+{
+    return (offset + PACK_ALIGNMENT - 1) & ~(PACK_ALIGNMENT - 1);
+}
+
+std::string_view TrimPackPath(std::string_view path)
+{
+    while (true)
+    {
+        if (path.starts_with("./") || path.starts_with(".\\"))
+        {
+            path.remove_prefix(2);
+        }
+        else if (path.starts_with('/') || path.starts_with('\\'))
+        {
+            path.remove_prefix(1);
+        }
+        else
+        {
+            return path;
+        }
+    }
+}
+
+/**
+ * @brief CompressChunks writes the chunk table followed by the chunks, a chunk that does not shrink is kept raw
+ */
+std::vector<unsigned char> CompressChunks(std::string_view data, std::uint32_t chunkSize)
+{
+    const std::size_t chunkCount = (data.size() + chunkSize - 1) / chunkSize;
+    std::vector<unsigned char> payload(chunkCount * sizeof(std::uint32_t));
+    payload.reserve(payload.size() + data.size());
+    std::vector<unsigned char> chunkBuffer(ZSTD_compressBound(chunkSize));
+    std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> context(ZSTD_createCCtx(), &ZSTD_freeCCtx);
+    for (std::size_t chunkIndex = 0; chunkIndex < chunkCount; chunkIndex++)
+    {
+        const auto chunk = data.substr(chunkIndex * chunkSize, chunkSize);
+        const auto compressedSize = ZSTD_compressCCtx(context.get(), chunkBuffer.data(), chunkBuffer.size(),
+            chunk.data(), chunk.size(), PACK_COMPRESSION_LEVEL);
+        std::uint32_t tableValue = 0;
+        if (ZSTD_isError(compressedSize) || compressedSize >= chunk.size())
+        {
+            payload.insert(payload.end(), chunk.begin(), chunk.end());
+            tableValue = static_cast<std::uint32_t>(chunk.size()) | PACK_RAW_CHUNK_FLAG;
+        }
+        else
+        {
+            payload.insert(payload.end(), chunkBuffer.begin(), chunkBuffer.begin() + static_cast<std::ptrdiff_t>(compressedSize));
+            tableValue = static_cast<std::uint32_t>(compressedSize);
+        }
+        std::memcpy(payload.data() + chunkIndex * sizeof(std::uint32_t), &tableValue, sizeof(tableValue));
+    }
+    return payload;
+}
+
+bool ReadDiskFile(const std::string& path, std::string& data)
+{
+    std::ifstream file(path, std::ifstream::binary);
+    if (!file)
+    {
+        return false;
+    }
+    data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+} // namespace
+
+std::string NormalizePackPath(std::string_view path)
+{
+    std::string normalizedPath(TrimPackPath(path));
+    std::ranges::replace(normalizedPath, '\\', '/');
+    return normalizedPath;
+}
+
+void PackWriter::AddFile(std::string_view diskPath, std::string_view packPath, PackCompression compression)
+{
+    sources_.push_back({
+        NormalizePackPath(packPath.empty() ? diskPath : packPath),
+        std::string(diskPath),
+        {},
+        compression });
+}
+
+void PackWriter::AddData(std::string_view packPath, std::string data, PackCompression compression)
+{
+    sources_.push_back({ NormalizePackPath(packPath), {}, std::move(data), compression });
+}
+
+bool PackWriter::Write(std::string_view path, int queueIndex) const
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    struct EncodedEntry
+    {
+        const PackSource* source = nullptr;
+        PackEntry entry;
+        std::vector<unsigned char> payload;
+        bool hasError = false;
+        bool isReused = false;
+        // index of the entry holding the data, entries with the same content share it
+        std::size_t dataIndex = 0;
+    };
+    std::vector<EncodedEntry> encodedEntries;
+    encodedEntries.reserve(sources_.size());
+    std::unordered_map<std::uint64_t, std::string_view> packPaths;
+    for (const auto& source : sources_)
+    {
+        const auto pathHash = HashString(source.packPath);
+        const auto [pathIt, inserted] = packPaths.emplace(pathHash, source.packPath);
+        if (!inserted)
+        {
+            if (pathIt->second != source.packPath)
+            {
+                LogError(fmt::format("Could not write pack, hash collision between {} and {}", pathIt->second, source.packPath));
+                return false;
+            }
+            continue;
+        }
+        auto& encodedEntry = encodedEntries.emplace_back();
+        encodedEntry.source = &source;
+        encodedEntry.entry.pathHash = pathHash;
+    }
+
+    // the entries of the previous pack can be kept as long as their content did not change
+    PackFilesystem previousPack;
+    std::unordered_map<std::uint64_t, const PackEntry*> previousContents;
+    const std::string pathString(path);
+    if (std::filesystem::exists(pathString) && previousPack.Mount(path))
+    {
+        for (const auto& entry : previousPack.entries_)
+        {
+            previousContents.emplace(entry.contentHash, &entry);
+        }
+    }
+
+    ParallelFor(0, encodedEntries.size(), 1, [&encodedEntries, &previousContents, &previousPack](std::size_t index)
+    {
+#ifdef TRACY_ENABLE
+        ZoneScopedN("Encode Pack Entry");
+#endif
+        auto& encodedEntry = encodedEntries[index];
+        const auto& source = *encodedEntry.source;
+        std::string diskData;
+        if (!source.diskPath.empty() && !ReadDiskFile(source.diskPath, diskData))
+        {
+            encodedEntry.hasError = true;
+            return;
+        }
+        const std::string_view data = source.diskPath.empty() ? std::string_view(source.data) : diskData;
+        auto& entry = encodedEntry.entry;
+        entry.size = data.size();
+        entry.contentHash = HashBytes(data.data(), data.size());
+        // a matching hash is not enough, the previous entry is only kept if its bytes and compression match
+        const auto previousIt = previousContents.find(entry.contentHash);
+        const auto reusePrevious = [&]()
+        {
+            if (previousIt == previousContents.end() || previousIt->second->compression != entry.compression ||
+                !previousPack.HasContent(*previousIt->second, data))
+            {
+                return false;
+            }
+            entry.offset = previousIt->second->offset;
+            entry.storedSize = previousIt->second->storedSize;
+            encodedEntry.payload = {};
+            encodedEntry.isReused = true;
+            return true;
+        };
+        entry.compression = data.empty() ? PackCompression::STORED : source.compression;
+        if (reusePrevious())
+        {
+            return;
+        }
+        if (entry.compression == PackCompression::ZSTD)
+        {
+            encodedEntry.payload = CompressChunks(data, PACK_CHUNK_SIZE);
+            // not worth decompressing, keep it stored so it can be used in place
+            if (encodedEntry.payload.size() > data.size() / 8 * 7)
+            {
+                entry.compression = PackCompression::STORED;
+                // the previous write may have stored it too
+                if (reusePrevious())
+                {
+                    return;
+                }
+            }
+        }
+        if (entry.compression == PackCompression::STORED)
+        {
+            encodedEntry.payload.assign(data.begin(), data.end());
+        }
+        entry.storedSize = encodedEntry.payload.size();
+    }, queueIndex);
+
+    std::size_t reusedCount = 0;
+    for (const auto& encodedEntry : encodedEntries)
+    {
+        if (encodedEntry.hasError)
+        {
+            LogError(fmt::format("Could not write pack, missing file: {}", encodedEntry.source->diskPath));
+            return false;
+        }
+        reusedCount += encodedEntry.isReused ? 1 : 0;
+    }
+    std::ranges::sort(encodedEntries, [](const auto& a, const auto& b)
+    {
+        return a.entry.pathHash < b.entry.pathHash;
+    });
+    // identical files are only written once
+    std::unordered_map<std::uint64_t, std::size_t> dataEntries;
+    std::size_t duplicateCount = 0;
+    for (std::size_t index = 0; index < encodedEntries.size(); index++)
+    {
+        auto& encodedEntry = encodedEntries[index];
+        encodedEntry.dataIndex = index;
+        const auto [dataIt, inserted] = dataEntries.emplace(encodedEntry.entry.contentHash, index);
+        const auto& dataEntry = encodedEntries[dataIt->second];
+        if (!inserted && dataEntry.entry.size == encodedEntry.entry.size && dataEntry.isReused == encodedEntry.isReused &&
+            dataEntry.entry.compression == encodedEntry.entry.compression && dataEntry.payload == encodedEntry.payload)
+        {
+            encodedEntry.dataIndex = dataIt->second;
+            encodedEntry.payload = {};
+            duplicateCount++;
+        }
+    }
+
+    PackHeader header;
+    header.magic = PACK_MAGIC;
+    header.version = PACK_VERSION;
+    header.entryCount = static_cast<std::uint32_t>(encodedEntries.size());
+    header.chunkSize = PACK_CHUNK_SIZE;
+    std::string paths;
+    for (auto& encodedEntry : encodedEntries)
+    {
+        encodedEntry.entry.pathOffset = static_cast<std::uint32_t>(paths.size());
+        encodedEntry.entry.pathLength = static_cast<std::uint32_t>(encodedEntry.source->packPath.size());
+        paths += encodedEntry.source->packPath;
+        paths.push_back(0);
+    }
+    const auto indexSize = encodedEntries.size() * sizeof(PackEntry) + paths.size();
+
+    // an incremental write appends the new entries and a new index after the previous pack, then points the header
+    // to them. It is worth it as long as the previous exports did not leave too much unused data.
+    std::uint64_t reusedSize = 0;
+    for (std::size_t index = 0; index < encodedEntries.size(); index++)
+    {
+        if (encodedEntries[index].isReused && encodedEntries[index].dataIndex == index)
+        {
+            reusedSize += AlignPackOffset(encodedEntries[index].entry.storedSize + 1);
+        }
+    }
+    const bool isIncremental = previousPack.IsMounted() &&
+        previousPack.pack_.size - previousPack.dataOffset_ <= 2 * reusedSize + PACK_ALIGNMENT;
+    header.dataOffset = isIncremental ? previousPack.dataOffset_ : AlignPackOffset(sizeof(PackHeader) + indexSize);
+
+    const std::vector<char> padding(PACK_ALIGNMENT, 0);
+    const std::uint64_t dataBegin = isIncremental ? previousPack.pack_.size : header.dataOffset;
+    std::uint64_t offset = dataBegin;
+    std::vector<const EncodedEntry*> writtenEntries;
+    for (std::size_t index = 0; index < encodedEntries.size(); index++)
+    {
+        auto& encodedEntry = encodedEntries[index];
+        if (encodedEntry.dataIndex != index || (encodedEntry.isReused && isIncremental))
+        {
+            continue;
+        }
+        if (encodedEntry.isReused)
+        {
+            // the previous pack is rewritten, the data of the unchanged entry is copied from it
+            const auto* previousData = previousPack.pack_.data + encodedEntry.entry.offset;
+            encodedEntry.payload.assign(previousData, previousData + encodedEntry.entry.storedSize);
+        }
+        encodedEntry.entry.offset = offset;
+        // at least one zero byte after each entry keeps the stored entries null-terminated
+        offset = AlignPackOffset(offset + encodedEntry.entry.storedSize + 1);
+        writtenEntries.push_back(&encodedEntry);
+    }
+    for (auto& encodedEntry : encodedEntries)
+    {
+        const auto& dataEntry = encodedEntries[encodedEntry.dataIndex].entry;
+        encodedEntry.entry.offset = dataEntry.offset;
+        encodedEntry.entry.storedSize = dataEntry.storedSize;
+        encodedEntry.entry.compression = dataEntry.compression;
+    }
+    previousPack.Unmount();
+    // a full write puts the index after the header, an incremental one after the appended data
+    header.indexOffset = isIncremental ? offset : sizeof(PackHeader);
+    header.pathsOffset = header.indexOffset + encodedEntries.size() * sizeof(PackEntry);
+
+    const auto writePath = isIncremental ? pathString : pathString + ".tmp";
+    std::fstream file(writePath, isIncremental ?
+        std::ios::binary | std::ios::in | std::ios::out :
+        std::ios::binary | std::ios::out | std::ios::trunc);
+    if (!file)
+    {
+        LogError(fmt::format("Could not open pack for writing: {}", writePath));
+        return false;
+    }
+    // the previous data and index are never overwritten, until the header is written the pack stays the previous one
+    file.seekp(static_cast<std::streamoff>(dataBegin));
+    std::uint64_t position = dataBegin;
+    for (const auto* encodedEntry : writtenEntries)
+    {
+        file.write(padding.data(), static_cast<std::streamsize>(encodedEntry->entry.offset - position));
+        file.write(reinterpret_cast<const char*>(encodedEntry->payload.data()), static_cast<std::streamsize>(encodedEntry->payload.size()));
+        position = encodedEntry->entry.offset + encodedEntry->payload.size();
+    }
+    file.write(padding.data(), static_cast<std::streamsize>(offset - position));
+    file.seekp(static_cast<std::streamoff>(header.indexOffset));
+    for (const auto& encodedEntry : encodedEntries)
+    {
+        file.write(reinterpret_cast<const char*>(&encodedEntry.entry), sizeof(PackEntry));
+    }
+    file.write(paths.data(), static_cast<std::streamsize>(paths.size()));
+    if (!isIncremental)
+    {
+        file.write(padding.data(), static_cast<std::streamsize>(header.dataOffset - header.pathsOffset - paths.size()));
+    }
+    // the header is written last, in a single small write once the data and the index are flushed
+    file.flush();
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.close();
+    if (!file)
+    {
+        LogError(fmt::format("Could not write pack: {}", writePath));
+        return false;
+    }
+    if (!isIncremental)
+    {
+        std::error_code error;
+        std::filesystem::rename(writePath, pathString, error);
+        if (error)
+        {
+            LogError(fmt::format("Could not replace pack: {} {}", path, error.message()));
+            return false;
+        }
+    }
+    LogDebug(fmt::format("Pack {} written{}: {} entries, {} unchanged, {} duplicates, {} bytes written",
+        path, isIncremental ? " incrementally" : "", encodedEntries.size(), reusedCount, duplicateCount,
+        offset - dataBegin));
+    return true;
+}
+
+bool PackFilesystem::Mount(std::string_view path)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    Unmount();
+    auto pack = FileBuffer::Map(path, FileAccessHint::NONE);
+    if (pack.data == nullptr || pack.size < sizeof(PackHeader))
+    {
+        LogError(fmt::format("Could not mount pack: {}", path));
+        return false;
+    }
+    PackHeader header;
+    std::memcpy(&header, pack.data, sizeof(header));
+    if (header.magic != PACK_MAGIC || header.version != PACK_VERSION || header.chunkSize == 0)
+    {
+        LogError(fmt::format("Could not mount pack, invalid header: {}", path));
+        return false;
+    }
+    // incremental writes append the index after the data
+    if (header.indexOffset % alignof(PackEntry) != 0 ||
+        header.indexOffset + std::uint64_t{ header.entryCount } * sizeof(PackEntry) > header.pathsOffset ||
+        header.pathsOffset > pack.size || header.dataOffset > pack.size)
+    {
+        LogError(fmt::format("Could not mount pack, invalid index: {}", path));
+        return false;
+    }
+    const std::span entries(reinterpret_cast<const PackEntry*>(pack.data + header.indexOffset), header.entryCount);
+    for (const auto& entry : entries)
+    {
+        if (entry.offset + entry.storedSize > pack.size ||
+            header.pathsOffset + entry.pathOffset + entry.pathLength > pack.size)
+        {
+            LogError(fmt::format("Could not mount pack, entry out of bounds: {}", path));
+            return false;
+        }
+    }
+    pack_ = std::move(pack);
+    entries_ = entries;
+    paths_ = reinterpret_cast<const char*>(pack_.data + header.pathsOffset);
+    dataOffset_ = header.dataOffset;
+    chunkSize_ = header.chunkSize;
+    return true;
+}
+
+void PackFilesystem::Unmount()
+{
+    entries_ = {};
+    paths_ = nullptr;
+    pack_ = {};
+}
+
+std::string_view PackFilesystem::GetEntryPath(const PackEntry& entry) const
+{
+    return { paths_ + entry.pathOffset, entry.pathLength };
+}
+
+const PackEntry* PackFilesystem::FindEntry(std::string_view path) const
+{
+    std::string normalizedPath;
+    path = TrimPackPath(path);
+    if (path.find('\\') != std::string_view::npos)
+    {
+        normalizedPath = NormalizePackPath(path);
+        path = normalizedPath;
+    }
+    const auto pathHash = HashString(path);
+    auto it = std::ranges::lower_bound(entries_, pathHash, {}, &PackEntry::pathHash);
+    for (; it != entries_.end() && it->pathHash == pathHash; ++it)
+    {
+        if (GetEntryPath(*it) == path)
+        {
+            return &*it;
+        }
+    }
+    return nullptr;
+}
+
+FileBuffer PackFilesystem::LoadFile(const Path &path) const
+{
+    return LoadFileStreamed(path, 0, {});
+}
+
+FileBuffer PackFilesystem::LoadFileStreamed(const Path &path, std::size_t chunkSize, const FileLoadProgress& onProgress) const
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+    ZoneText(path.c_str(), path.size());
+#endif
+    const auto* entry = FindEntry(path);
+    if (entry == nullptr)
+    {
+        LogError(fmt::format("File does not exist in pack: {}", path.c_str()));
+        return {};
+    }
+    auto* payload = pack_.data + entry->offset;
+    if (entry->compression == PackCompression::STORED)
+    {
+        return FileBuffer::View(payload, entry->size);
+    }
+
+    const auto size = static_cast<std::size_t>(entry->size);
+    FileBuffer fileBuffer;
+    fileBuffer.data = static_cast<unsigned char*>(std::malloc(size + 1));
+    if (fileBuffer.data == nullptr)
+    {
+        LogError(fmt::format("Could not allocate {} bytes to load pack file: {}", size + 1, path.c_str()));
+        return fileBuffer;
+    }
+    fileBuffer.data[size] = 0;
+    fileBuffer.size = size;
+    if (!DecompressRange(*entry, 0, size, fileBuffer.data, onProgress, chunkSize))
+    {
+        LogError(fmt::format("Could not decompress pack file: {}", path.c_str()));
+        return {};
+    }
+    return fileBuffer;
+}
+
+std::size_t PackFilesystem::GetFileSize(const Path &path) const
+{
+    const auto* entry = FindEntry(path);
+    return entry == nullptr ? 0 : static_cast<std::size_t>(entry->size);
+}
+
+bool PackFilesystem::DecompressRange(const PackEntry& entry, std::size_t offset, std::size_t size, unsigned char* destination,
+    const FileLoadProgress& onProgress, std::size_t progressSize) const
+{
+    const auto* payload = pack_.data + entry.offset;
+    const auto* payloadEnd = payload + entry.storedSize;
+    const auto fileSize = static_cast<std::size_t>(entry.size);
+    const std::size_t chunkCount = (fileSize + chunkSize_ - 1) / chunkSize_;
+    const auto* chunk = payload + chunkCount * sizeof(std::uint32_t);
+    const auto rangeEnd = offset + size;
+    std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> context(ZSTD_createDCtx(), &ZSTD_freeDCtx);
+    // the first and last chunks of a range are only partially copied
+    std::vector<unsigned char> partialChunk;
+    std::size_t nextProgress = progressSize;
+    for (std::size_t chunkIndex = 0; chunkIndex < chunkCount; chunkIndex++)
+    {
+        std::uint32_t tableValue = 0;
+        std::memcpy(&tableValue, payload + chunkIndex * sizeof(std::uint32_t), sizeof(tableValue));
+        const std::size_t storedChunkSize = tableValue & ~PACK_RAW_CHUNK_FLAG;
+        const auto chunkOffset = chunkIndex * chunkSize_;
+        const auto chunkSize = std::min<std::size_t>(chunkSize_, fileSize - chunkOffset);
+        const auto* storedChunk = chunk;
+        chunk += storedChunkSize;
+        if (chunkOffset + chunkSize <= offset)
+        {
+            continue;
+        }
+        if (chunkOffset >= rangeEnd)
+        {
+            break;
+        }
+        if (storedChunk + storedChunkSize > payloadEnd)
+        {
+            return false;
+        }
+        const auto copyBegin = std::max(offset, chunkOffset);
+        const auto copyEnd = std::min(rangeEnd, chunkOffset + chunkSize);
+        const bool isPartial = copyBegin != chunkOffset || copyEnd != chunkOffset + chunkSize;
+        if ((tableValue & PACK_RAW_CHUNK_FLAG) != 0)
+        {
+            if (storedChunkSize != chunkSize)
+            {
+                return false;
+            }
+            std::memcpy(destination + (copyBegin - offset), storedChunk + (copyBegin - chunkOffset), copyEnd - copyBegin);
+        }
+        else
+        {
+            if (isPartial)
+            {
+                partialChunk.resize(chunkSize);
+            }
+            auto* chunkDestination = isPartial ? partialChunk.data() : destination + (chunkOffset - offset);
+            const auto result = ZSTD_decompressDCtx(context.get(), chunkDestination, chunkSize, storedChunk, storedChunkSize);
+            if (ZSTD_isError(result) || result != chunkSize)
+            {
+                return false;
+            }
+            if (isPartial)
+            {
+                std::memcpy(destination + (copyBegin - offset), partialChunk.data() + (copyBegin - chunkOffset), copyEnd - copyBegin);
+            }
+        }
+        const auto decompressedSize = copyEnd - offset;
+        if (onProgress && decompressedSize >= nextProgress && decompressedSize < size)
+        {
+            onProgress(destination, decompressedSize);
+            nextProgress = decompressedSize + progressSize;
+        }
+    }
+    return true;
+}
+
+bool PackFilesystem::HasContent(const PackEntry& entry, std::string_view data) const
+{
+    if (entry.size != data.size() || entry.offset + entry.storedSize > pack_.size)
+    {
+        return false;
+    }
+    if (data.empty())
+    {
+        return true;
+    }
+    if (entry.compression == PackCompression::STORED)
+    {
+        return std::memcmp(pack_.data + entry.offset, data.data(), data.size()) == 0;
+    }
+    std::vector<unsigned char> content(data.size());
+    return DecompressRange(entry, 0, content.size(), content.data()) &&
+        std::memcmp(content.data(), data.data(), data.size()) == 0;
+}
+
+bool PackFilesystem::FileExists(const Path &path) const
+{
+    return FindEntry(path) != nullptr || IsDirectory(path);
+}
+
+bool PackFilesystem::IsRegularFile(const Path &path) const
+{
+    return FindEntry(path) != nullptr;
+}
+
+bool PackFilesystem::IsDirectory(const Path &path) const
+{
+    auto directory = NormalizePackPath(path);
+    while (directory.ends_with('/'))
+    {
+        directory.pop_back();
+    }
+    if (directory.empty())
+    {
+        return IsMounted();
+    }
+    directory.push_back('/');
+    return std::ranges::any_of(entries_, [this, &directory](const auto& entry)
+    {
+        return GetEntryPath(entry).starts_with(directory);
+    });
+}
+
+void PackFilesystem::WriteString(const Path &path, std::string_view content) const
+{
+    LogWarning(fmt::format("Could not write {}, pack filesystem is read-only", path.c_str()));
+}
+
+} // namespace core
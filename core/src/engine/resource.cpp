@@ -14,6 +14,14 @@ namespace fs = std::filesystem;
 namespace core
 {
 
+namespace
+{
+Path NormalizeResourcePath(std::string_view path)
+{
+    return Path(fs::path(path).lexically_normal().generic_string());
+}
+}
+
 ResourceManager* instance = nullptr;
 
 ResourceManager::ResourceManager()
@@ -23,8 +31,20 @@ ResourceManager::ResourceManager()
 
 void ResourceManager::Begin()
 {
-    auto* jobSystem = GetJobSystem();
-    resourceLoadQueue_ = jobSystem->SetupNewQueue();
+    // the resources are loaded on the file I/O queue when there is one
+    resourceLoadQueue_ = FilesystemLocator::get().GetIoQueue();
+    if (resourceLoadQueue_ == MAIN_QUEUE_INDEX)
+    {
+        auto* jobSystem = GetJobSystem();
+        resourceLoadQueue_ = jobSystem->SetupNewQueue(loadingLimits_.ioThreadCount, {}, "Resource Loader");
+        if (resourceLoadQueue_ == INVALID_QUEUE_INDEX)
+        {
+            LogError("Could not create the resource loader queue, the resources are loaded on the main thread");
+            resourceLoadQueue_ = MAIN_QUEUE_INDEX;
+        }
+    }
+    // the resources are decoded on the general worker queue, the first one
+    resourceDecodeQueue_ = GetJobSystem()->GetQueueWorkerCount(0) > 0 ? 0 : resourceLoadQueue_;
 }
 
 void ResourceManager::Update(float dt)
@@ -32,17 +52,14 @@ void ResourceManager::Update(float dt)
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
-    //execute all moving filebuffer tasks
-    while(!moveFileBufferJobs_.empty())
+    // drain the completions published by the loader threads in a single pass
+    ResourceCompletion completion;
+    while (completionRing_.Pop(completion))
     {
-        std::unique_ptr<MoveFileBufferJob> job = nullptr;
-        {
-            std::scoped_lock lock(resourceLoadMutex_);
-            job = std::move(moveFileBufferJobs_.front());
-            moveFileBufferJobs_.pop();
-        }
-        job->Execute();
+        ApplyCompletion(completion);
     }
+    DispatchLoads();
+    EvictOverBudget();
 }
 
 void ResourceManager::End()
@@ -50,55 +67,109 @@ void ResourceManager::End()
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
-    while(!moveFileBufferJobs_.empty())
+    ResourceCompletion completion;
+    while (completionRing_.Pop(completion))
     {
-        moveFileBufferJobs_.pop();
     }
-    fileBuffers_.clear();
+    pendingLoads_.clear();
+    pendingDecodes_.clear();
+    ioLoadsInFlight_ = 0;
+    decodesInFlight_ = 0;
+    freeFileIndices_.clear();
+    for (auto& resource : resources_)
+    {
+        // the slots of the loading resources are still written by the loader threads
+        if (resource.fileIndex != -1 && !resource.isLoading)
+        {
+            fileBuffers_[resource.fileIndex] = {};
+            decodedData_[resource.fileIndex] = nullptr;
+            freeFileIndices_.push_back(resource.fileIndex);
+        }
+        resource.fileIndex = -1;
+        resource.hasLoaded = false;
+        resource.isLoading = false;
+        resource.streamedData = nullptr;
+        resource.loadedSize = 0;
+        resource.lruPrevious = -1;
+        resource.lruNext = -1;
+    }
+    lruHead_ = -1;
+    lruTail_ = -1;
+    cacheStats_.residentBytes = 0;
+}
+
+SystemAccess ResourceManager::GetAccess() const
+{
+    // Update only moves the loaded file buffers, it does not need the main thread
+    return { SystemResource::FILE_BUFFERS, SystemResource::FILE_BUFFERS, false };
 }
 
-ResourceId ResourceManager::AddResource(std::string_view path)
+ResourceHandle ResourceManager::AddResource(std::string_view path)
 {
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
     if (path.empty())
-        return INVALID_RESOURCE_ID;
+        return {};
 
     const auto& filesystem = core::FilesystemLocator::get();
     if(!filesystem.FileExists(Path(path)))
     {
         LogWarning(fmt::format("Adding unexisting resource: {}", path));
-        return INVALID_RESOURCE_ID;
+        return {};
     }
 
-    const auto it = std::ranges::find_if(resources_, [path, &filesystem](const auto& resource)
+    const auto resourcePath = NormalizeResourcePath(path);
+    const auto pathIt = resourcePathIndex_.find(resourcePath);
+    if(pathIt != resourcePathIndex_.end())
     {
-        if (!filesystem.FileExists(resource.path))
-            return false;
-        return fs::equivalent(path.data(), resource.path.c_str());
-    });
-    if(it != resources_.end())
+        return AddExistingResource(pathIt->second);
+    }
+    // another path to an existing resource, like an absolute path or a link
+    const auto fileId = filesystem.GetFileId(Path(path));
+    if(fileId != INVALID_FILE_ID)
     {
-        return it->resourceId;
+        const auto fileIt = resourceFileIndex_.find(fileId);
+        if(fileIt != resourceFileIndex_.end())
+        {
+            resourcePathIndex_.emplace(resourcePath, fileIt->second);
+            return AddExistingResource(fileIt->second);
+        }
     }
 
-    const auto resourceId = (ResourceId)resources_.size();
+    // resource ids start at 1, 0 being the invalid resource id
+    const ResourceId resourceId = { static_cast<std::uint32_t>(resources_.size() + 1) };
+    resourcePathIndex_.emplace(resourcePath, resourceId);
+    if(fileId != INVALID_FILE_ID)
+    {
+        resourceFileIndex_.emplace(fileId, resourceId);
+    }
     resources_.emplace_back();
     Resource& newResource = resources_.back();
     newResource.path = Path(path);
     newResource.resourceId = resourceId;
+    LoadResource(newResource);
 
-    // adding a new loading job
-    auto* jobSystem = GetJobSystem();
-    jobSystem->AddJob(std::make_shared<LoadingResourceJob>(path, resourceId));
+    return { this, resourceId };
+}
 
-    return resourceId;
+ResourceHandle ResourceManager::AddExistingResource(ResourceId resourceId)
+{
+    auto& resource = resources_[GetResourceIndex(resourceId)];
+    if (!resource.hasLoaded && !resource.isLoading)
+    {
+        LoadResource(resource);
+    }
+    return { this, resourceId };
 }
 
 bool ResourceManager::HasLoaded(ResourceId resourceId) const
 {
-    return resources_[resourceId.value].hasLoaded;
+    if(resourceId == INVALID_RESOURCE_ID)
+    {
+        return false;
+    }
+    return resources_[GetResourceIndex(resourceId)].hasLoaded;
 }
 
 FileBuffer* ResourceManager::GetFileBuffer(ResourceId resourceId)
@@ -107,53 +178,457 @@ FileBuffer* ResourceManager::GetFileBuffer(ResourceId resourceId)
     {
         return nullptr;
     }
-    const auto& resource = resources_[resourceId.value];
-    if(resource.fileIndex < 0)
+    auto& resource = resources_[GetResourceIndex(resourceId)];
+    if(!resource.hasLoaded)
     {
+        cacheStats_.misses++;
+        if (!resource.isLoading)
+        {
+            LoadResource(resource);
+        }
         return nullptr;
     }
+    cacheStats_.hits++;
+    if (resource.refCount == 0)
+    {
+        RemoveFromLru(resource);
+        PushToLru(resource);
+    }
     return &fileBuffers_[resource.fileIndex];
 }
 
+std::span<const unsigned char> ResourceManager::GetLoadedData(ResourceId resourceId) const
+{
+    if(resourceId == INVALID_RESOURCE_ID)
+    {
+        return {};
+    }
+    const auto& resource = resources_[GetResourceIndex(resourceId)];
+    if (resource.streamedData == nullptr)
+    {
+        return {};
+    }
+    return { resource.streamedData, resource.loadedSize };
+}
+
+void ResourceManager::RegisterDecoder(std::string_view extension, ResourceDecoder decoder)
+{
+    decoders_[std::string(extension)] = std::move(decoder);
+}
+
+std::shared_ptr<void> ResourceManager::GetDecodedData(ResourceId resourceId) const
+{
+    if(resourceId == INVALID_RESOURCE_ID)
+    {
+        return nullptr;
+    }
+    const auto& resource = resources_[GetResourceIndex(resourceId)];
+    if (!resource.hasLoaded)
+    {
+        return nullptr;
+    }
+    return decodedData_[resource.fileIndex];
+}
+
+void ResourceManager::SetLoadingLimits(const ResourceLoadingLimits& loadingLimits)
+{
+    loadingLimits_ = loadingLimits;
+}
+
+void ResourceManager::SetMemoryBudget(std::size_t memoryBudget)
+{
+    memoryBudget_ = memoryBudget;
+}
+
+ResourceCacheStats ResourceManager::GetCacheStats() const
+{
+    auto cacheStats = cacheStats_;
+    cacheStats.memoryBudget = memoryBudget_;
+    return cacheStats;
+}
+
+void ResourceManager::ResetCacheStats()
+{
+    cacheStats_.hits = 0;
+    cacheStats_.misses = 0;
+    cacheStats_.evictions = 0;
+}
+
+void ResourceManager::AddReference(ResourceId resourceId)
+{
+    auto& resource = resources_[GetResourceIndex(resourceId)];
+    if (resource.refCount++ == 0 && resource.hasLoaded)
+    {
+        RemoveFromLru(resource);
+    }
+}
+
+void ResourceManager::RemoveReference(ResourceId resourceId)
+{
+    auto& resource = resources_[GetResourceIndex(resourceId)];
+    if (--resource.refCount == 0 && resource.hasLoaded)
+    {
+        PushToLru(resource);
+    }
+}
+
+void ResourceManager::LoadResource(Resource& resource)
+{
+    resource.isLoading = true;
+    pendingLoads_.push_back(resource.resourceId);
+    DispatchLoads();
+}
+
+void ResourceManager::DispatchLoads()
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    while (!pendingDecodes_.empty() && decodesInFlight_ < loadingLimits_.maxDecodes)
+    {
+        auto& resource = resources_[GetResourceIndex(pendingDecodes_.front())];
+        pendingDecodes_.pop_front();
+        StartDecode(resource);
+    }
+    // the read files waiting to be decoded keep their I/O slot, so reads stop when the decoding is behind
+    while (!pendingLoads_.empty() && ioLoadsInFlight_ + pendingDecodes_.size() < loadingLimits_.maxIoLoads)
+    {
+        auto& resource = resources_[GetResourceIndex(pendingLoads_.front())];
+        pendingLoads_.pop_front();
+        StartRead(resource);
+    }
+}
+
+void ResourceManager::StartRead(Resource& resource)
+{
+    if (freeFileIndices_.empty())
+    {
+        resource.fileIndex = static_cast<int>(fileBuffers_.size());
+        fileBuffers_.emplace_back();
+        decodedData_.emplace_back();
+    }
+    else
+    {
+        resource.fileIndex = freeFileIndices_.back();
+        freeFileIndices_.pop_back();
+    }
+    ioLoadsInFlight_++;
+    auto* jobSystem = GetJobSystem();
+    auto* loadingJob = loadingResourceJobPool_.Acquire(resource.path, resource.resourceId, &fileBuffers_[resource.fileIndex]);
+    loadingJob->SetPriority(JobPriority::BACKGROUND);
+    jobSystem->AddJob(loadingJob, resourceLoadQueue_);
+}
+
+void ResourceManager::StartDecode(Resource& resource)
+{
+    decodesInFlight_++;
+    auto* jobSystem = GetJobSystem();
+    auto* decodingJob = decodingResourceJobPool_.Acquire(resource, *FindDecoder(resource.path),
+        fileBuffers_[resource.fileIndex], &decodedData_[resource.fileIndex]);
+    decodingJob->SetPriority(JobPriority::BACKGROUND);
+    jobSystem->AddJob(decodingJob, resourceDecodeQueue_);
+}
+
+void ResourceManager::FinishLoad(Resource& resource)
+{
+    cacheStats_.residentBytes += fileBuffers_[resource.fileIndex].size;
+    resource.hasLoaded = true;
+    resource.isLoading = false;
+    if (resource.refCount == 0)
+    {
+        PushToLru(resource);
+    }
+}
+
+const ResourceDecoder* ResourceManager::FindDecoder(const Path& path) const
+{
+    if (decoders_.empty())
+    {
+        return nullptr;
+    }
+    const auto it = decoders_.find(fs::path(std::string_view(path)).extension().string());
+    return it == decoders_.end() ? nullptr : &it->second;
+}
+
+void ResourceManager::EvictOverBudget()
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    while (cacheStats_.residentBytes > memoryBudget_ && lruHead_ != -1)
+    {
+        auto& resource = resources_[lruHead_];
+        RemoveFromLru(resource);
+        auto& fileBuffer = fileBuffers_[resource.fileIndex];
+        cacheStats_.residentBytes -= fileBuffer.size;
+        fileBuffer = {};
+        decodedData_[resource.fileIndex] = nullptr;
+        freeFileIndices_.push_back(resource.fileIndex);
+        resource.fileIndex = -1;
+        resource.hasLoaded = false;
+        resource.streamedData = nullptr;
+        resource.loadedSize = 0;
+        cacheStats_.evictions++;
+    }
+}
+
+void ResourceManager::RemoveFromLru(Resource& resource)
+{
+    const auto index = static_cast<int>(GetResourceIndex(resource.resourceId));
+    if (resource.lruPrevious == -1 && lruHead_ != index)
+    {
+        return;
+    }
+    (resource.lruPrevious == -1 ? lruHead_ : resources_[resource.lruPrevious].lruNext) = resource.lruNext;
+    (resource.lruNext == -1 ? lruTail_ : resources_[resource.lruNext].lruPrevious) = resource.lruPrevious;
+    resource.lruPrevious = -1;
+    resource.lruNext = -1;
+}
+
+void ResourceManager::PushToLru(Resource& resource)
+{
+    const auto index = static_cast<int>(GetResourceIndex(resource.resourceId));
+    resource.lruPrevious = lruTail_;
+    resource.lruNext = -1;
+    (lruTail_ == -1 ? lruHead_ : resources_[lruTail_].lruNext) = index;
+    lruTail_ = index;
+}
+
 void ResourceManager::LoadingResourceJob::ExecuteImpl()
 {
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
     const auto& filesystem = core::FilesystemLocator::get();
-    fileBuffer_ = filesystem.LoadFile(Path(path_));
-    //add moving job to the ResourceManager
+    if (filesystem.GetFileSize(path_) >= RESOURCE_STREAMING_THRESHOLD)
+    {
+        StreamFile(filesystem);
+    }
+    else
+    {
+        *fileBuffer_ = filesystem.LoadFile(path_);
+    }
     auto* resourceManager = GetResourceManager();
-    std::scoped_lock lock(resourceManager->resourceLoadMutex_);
-    resourceManager->moveFileBufferJobs_.push(std::make_unique<MoveFileBufferJob>(std::move(fileBuffer_), resourceId_));
+    resourceManager->completionRing_.Push({ resourceId_, fileBuffer_->data, fileBuffer_->size, ResourceLoadStage::READ });
 }
 
-ResourceManager::LoadingResourceJob::LoadingResourceJob(std::string_view path, ResourceId resourceId) :
-    path_(path), resourceId_(resourceId)
+void ResourceManager::LoadingResourceJob::StreamFile(const FilesystemInterface& filesystem)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+    ZoneText(path_.c_str(), path_.size());
+#endif
+    // the main thread only reads the loaded chunks until the completion of the load
+    auto* resourceManager = GetResourceManager();
+    *fileBuffer_ = filesystem.LoadFileStreamed(path_, RESOURCE_STREAMING_CHUNK_SIZE,
+        [this, resourceManager](const unsigned char* data, std::size_t loadedSize)
+        {
+            resourceManager->completionRing_.Push({ resourceId_, data, loadedSize, ResourceLoadStage::STREAMING });
+        });
+}
+
+ResourceManager::LoadingResourceJob::LoadingResourceJob(std::string_view path, ResourceId resourceId, FileBuffer* fileBuffer) :
+    path_(path), resourceId_(resourceId), fileBuffer_(fileBuffer)
 {
 
 }
 
-ResourceManager *GetResourceManager()
+ResourceManager::DecodingResourceJob::DecodingResourceJob(const Resource& resource, const ResourceDecoder& decoder,
+    const FileBuffer& fileBuffer, std::shared_ptr<void>* decodedData) :
+    path_(resource.path), resourceId_(resource.resourceId), decoder_(decoder), fileBuffer_(fileBuffer),
+    decodedData_(decodedData)
 {
-    return instance;
+
 }
 
-void ResourceManager::MoveFileBufferJob::ExecuteImpl()
+void ResourceManager::DecodingResourceJob::ExecuteImpl()
 {
 #ifdef TRACY_ENABLE
     ZoneScoped;
+    ZoneText(path_.c_str(), path_.size());
 #endif
+    *decodedData_ = decoder_(path_, fileBuffer_);
+    if (*decodedData_ == nullptr)
+    {
+        LogWarning(fmt::format("Could not decode resource: {}", path_));
+    }
     auto* resourceManager = GetResourceManager();
-    auto fileIndex = resourceManager->fileBuffers_.size();
-    resourceManager->fileBuffers_.push_back(std::move(fileBuffer_));
-    resourceManager->resources_[resourceId_.value].fileIndex = (int)fileIndex;
-    resourceManager->resources_[resourceId_.value].hasLoaded = true;
+    resourceManager->completionRing_.Push({ resourceId_, fileBuffer_.data, fileBuffer_.size, ResourceLoadStage::DECODED });
+}
+
+ResourceManager *GetResourceManager()
+{
+    ValidateSystemAccess(SystemResource::FILE_BUFFERS);
+    return instance;
+}
+
+void ResourceManager::ApplyCompletion(const ResourceCompletion& completion)
+{
+    auto& resource = resources_[GetResourceIndex(completion.resourceId)];
+    if (!resource.isLoading)
+    {
+        // completion of a load that was in flight when the manager ended
+        return;
+    }
+    resource.streamedData = completion.data;
+    resource.loadedSize = completion.loadedSize;
+    switch (completion.stage)
+    {
+    case ResourceLoadStage::STREAMING:
+        break;
+    case ResourceLoadStage::READ:
+        ioLoadsInFlight_--;
+        if (FindDecoder(resource.path) != nullptr)
+        {
+            pendingDecodes_.push_back(resource.resourceId);
+        }
+        else
+        {
+            FinishLoad(resource);
+        }
+        break;
+    case ResourceLoadStage::DECODED:
+        decodesInFlight_--;
+        FinishLoad(resource);
+        break;
+    }
 }
 
-ResourceManager::MoveFileBufferJob::MoveFileBufferJob(FileBuffer&& filebuffer, ResourceId resourceId) :
-    fileBuffer_(std::move(filebuffer)), resourceId_(resourceId)
+ResourceCompletionRing::ResourceCompletionRing() : buffer_(std::make_unique<Cell[]>(CAPACITY))
 {
+    for (std::size_t i = 0; i < CAPACITY; i++)
+    {
+        buffer_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
 
+void ResourceCompletionRing::Push(const ResourceCompletion& completion)
+{
+    // once a producer overflowed, it keeps using the overflow until it is drained, to keep its completions in order
+    if (!hasOverflow_.load(std::memory_order_acquire) && TryPush(completion))
+    {
+        return;
+    }
+    std::scoped_lock lock(overflowMutex_);
+    overflow_.push_back(completion);
+    hasOverflow_.store(true, std::memory_order_release);
+}
+
+bool ResourceCompletionRing::TryPush(const ResourceCompletion& completion)
+{
+    auto pos = enqueuePos_.load(std::memory_order_relaxed);
+    while (true)
+    {
+        auto& cell = buffer_[pos & (CAPACITY - 1)];
+        const auto sequence = cell.sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+        if (diff == 0)
+        {
+            if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                cell.completion = completion;
+                cell.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0)
+        {
+            // ring is full
+            return false;
+        }
+        else
+        {
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool ResourceCompletionRing::Pop(ResourceCompletion& completion)
+{
+    // single consumer, the dequeue position does not need any compare and swap
+    auto& cell = buffer_[dequeuePos_ & (CAPACITY - 1)];
+    if (cell.sequence.load(std::memory_order_acquire) == dequeuePos_ + 1)
+    {
+        completion = cell.completion;
+        cell.sequence.store(dequeuePos_ + CAPACITY, std::memory_order_release);
+        dequeuePos_++;
+        return true;
+    }
+    if (!hasOverflow_.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+    std::scoped_lock lock(overflowMutex_);
+    if (overflow_.empty())
+    {
+        return false;
+    }
+    completion = overflow_.front();
+    overflow_.pop_front();
+    hasOverflow_.store(!overflow_.empty(), std::memory_order_release);
+    return true;
+}
+
+ResourceHandle::ResourceHandle(ResourceManager* resourceManager, ResourceId resourceId) :
+    resourceManager_(resourceManager), resourceId_(resourceId)
+{
+    if (IsValid())
+    {
+        resourceManager_->AddReference(resourceId_);
+    }
+}
+
+ResourceHandle::~ResourceHandle()
+{
+    Reset();
+}
+
+ResourceHandle::ResourceHandle(const ResourceHandle& other) :
+    ResourceHandle(other.resourceManager_, other.resourceId_)
+{
+}
+
+ResourceHandle& ResourceHandle::operator=(const ResourceHandle& other)
+{
+    if (this != &other)
+    {
+        ResourceHandle copy(other);
+        std::swap(resourceManager_, copy.resourceManager_);
+        std::swap(resourceId_, copy.resourceId_);
+    }
+    return *this;
+}
+
+ResourceHandle::ResourceHandle(ResourceHandle&& other) noexcept
+{
+    std::swap(resourceManager_, other.resourceManager_);
+    std::swap(resourceId_, other.resourceId_);
+}
+
+ResourceHandle& ResourceHandle::operator=(ResourceHandle&& other) noexcept
+{
+    std::swap(resourceManager_, other.resourceManager_);
+    std::swap(resourceId_, other.resourceId_);
+    return *this;
+}
+
+bool ResourceHandle::HasLoaded() const
+{
+    return IsValid() && resourceManager_->HasLoaded(resourceId_);
+}
+
+FileBuffer* ResourceHandle::GetFileBuffer() const
+{
+    return IsValid() ? resourceManager_->GetFileBuffer(resourceId_) : nullptr;
+}
+
+void ResourceHandle::Reset()
+{
+    if (IsValid())
+    {
+        resourceManager_->RemoveReference(resourceId_);
+    }
+    resourceManager_ = nullptr;
+    resourceId_ = INVALID_RESOURCE_ID;
+}
 }
-}
\ No newline at end of file
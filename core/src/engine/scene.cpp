@@ -7,6 +7,7 @@
 #include "renderer/pipeline.h"
 #include "renderer/framebuffer.h"
 #include "renderer/model.h"
+#include "renderer/vertex_layout.h"
 
 #include <SDL.h>
 #include <fmt/format.h>
@@ -69,6 +70,11 @@ void Scene::LoadScene()
         LogError("Could not import buffers");
     }
 
+    if (!CheckVertexLayouts(scene_))
+    {
+        LogError("Vertex layouts of the meshes and the pipelines do not match");
+    }
+
     if(LoadDrawCommands(renderPass) != ImportStatus::SUCCESS)
     {
         LogError("Could not import draw commands");
@@ -206,6 +212,14 @@ void SceneManager::End()
     }
 }
 
+SystemAccess SceneManager::GetAccess() const
+{
+    // scripts can draw and use the render API, draw commands bind textures and loading a scene imports its models
+    constexpr auto access = SystemResource::SCENE | SystemResource::SCRIPTS | SystemResource::BUFFERS |
+        SystemResource::TEXTURES | SystemResource::MODELS;
+    return { access, access, true };
+}
+
 void SceneManager::OnEvent(SDL_Event& event)
 {
     if(currentScene_ == nullptr)
@@ -215,6 +229,7 @@ void SceneManager::OnEvent(SDL_Event& event)
 
 Scene* GetCurrentScene()
 {
+    ValidateSystemAccess(SystemResource::SCENE);
     if (sceneManagerInstance != nullptr)
     {
         return sceneManagerInstance->GetCurrentScene();
@@ -0,0 +1,40 @@
+#include "engine/system.h"
+#include "utils/log.h"
+
+#include <fmt/format.h>
+
+#include <typeinfo>
+
+namespace core
+{
+
+static thread_local const System* currentSystem = nullptr;
+
+SystemAccessScope::SystemAccessScope(const System* system) : previousSystem_(currentSystem)
+{
+    currentSystem = system;
+}
+
+SystemAccessScope::~SystemAccessScope()
+{
+    currentSystem = previousSystem_;
+}
+
+void ValidateSystemAccess([[maybe_unused]] SystemResource resource)
+{
+#ifdef SYSTEM_VALIDATION_ENABLE
+    if (currentSystem == nullptr)
+    {
+        return;
+    }
+    const auto access = currentSystem->GetAccess();
+    if ((resource & (access.reads | access.writes)) == SystemResource::NONE)
+    {
+        LogError(fmt::format("System {} accessed undeclared resource {:#x}",
+            typeid(*currentSystem).name(),
+            static_cast<std::uint32_t>(resource)));
+    }
+#endif
+}
+
+} // namespace core
@@ -1,4 +1,5 @@
 #include "renderer/mesh.h"
+#include "renderer/mesh_tangents.h"
 #include "maths/angle.h"
 
 namespace core
@@ -19,34 +20,13 @@ Mesh GenerateQuad(glm::vec3 scale, glm::vec3 offset)
         {glm::vec3(-0.5f, -0.5f, 0.0f) * scale + offset, glm::vec2(0.0f, 0.0f), glm::vec3(0,0,-1)},  // bottom left
         {glm::vec3(-0.5f, 0.5f, 0.0f) * scale + offset, glm::vec2(0.0f, 1.0f), glm::vec3(0,0,-1)},// top left
     };
-    
-    {
-        const glm::vec3 edge1 = mesh.vertices[1].position - mesh.vertices[0].position;
-        const glm::vec3 edge2 = mesh.vertices[2].position - mesh.vertices[0].position;
-        const glm::vec2 deltaUV1 = mesh.vertices[1].texCoords - mesh.vertices[0].texCoords;
-        const glm::vec2 deltaUV2 = mesh.vertices[2].texCoords - mesh.vertices[0].texCoords;
-
-        const float f = 1.0f / (deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y);
-        mesh.vertices[0].tangent.x = f * (deltaUV2.y * edge1.x - deltaUV1.y * edge2.x);
-        mesh.vertices[0].tangent.y = f * (deltaUV2.y * edge1.y - deltaUV1.y * edge2.y);
-        mesh.vertices[0].tangent.z = f * (deltaUV2.y * edge1.z - deltaUV1.y * edge2.z);
-
-        mesh.vertices[0].bitangent.x = f * (-deltaUV2.x * edge1.x + deltaUV1.x * edge2.x);
-        mesh.vertices[0].bitangent.y = f * (-deltaUV2.x * edge1.y + deltaUV1.x * edge2.y);
-        mesh.vertices[0].bitangent.z = f * (-deltaUV2.x * edge1.z + deltaUV1.x * edge2.z);
-
-        mesh.vertices[1].tangent = mesh.vertices[0].tangent;
-        mesh.vertices[2].tangent = mesh.vertices[0].tangent;
-
-        mesh.vertices[1].bitangent = mesh.vertices[0].bitangent;
-        mesh.vertices[2].bitangent = mesh.vertices[0].bitangent;
-    }
 
     mesh.indices = {
         // note that we start from 0!
         0, 1, 3,   // first triangle
         1, 2, 3    // second triangle
     };
+    GenerateTangents(mesh);
     return mesh;
 }
 Mesh GenerateCube(glm::vec3 scale, glm::vec3 offset)
@@ -99,33 +79,7 @@ Mesh GenerateCube(glm::vec3 scale, glm::vec3 offset)
         {glm::vec3(0.5f, -0.5f, -0.5f) * scale + offset , glm::vec2(1.0f, 0.0f),glm::vec3(0.0f, 0.0f, -1.0f),},//22
         {glm::vec3(-0.5f, 0.5f, -0.5f) * scale + offset , glm::vec2(0.0f, 1.0f),glm::vec3(0.0f, 0.0f, -1.0f),},//23
     };
-    for (int i = 0; i < 36; i += 3)
-    {
-        std::array triIndices =
-        {
-            cube.indices[i],
-            cube.indices[i + 1],
-            cube.indices[i + 2],
-        };
-        const glm::vec3 edge1 = cube.vertices[triIndices[1]].position - cube.vertices[triIndices[0]].position;
-        const glm::vec3 edge2 = cube.vertices[triIndices[2]].position - cube.vertices[triIndices[0]].position;
-        const glm::vec2 deltaUV1 = cube.vertices[triIndices[1]].texCoords - cube.vertices[triIndices[0]].texCoords;
-        const glm::vec2 deltaUV2 = cube.vertices[triIndices[2]].texCoords - cube.vertices[triIndices[0]].texCoords;
-
-        const float f =
-            1.0f / (deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y);
-        cube.vertices[triIndices[0]].tangent.x = f * (deltaUV2.y * edge1.x - deltaUV1.y * edge2.x);
-        cube.vertices[triIndices[0]].tangent.y = f * (deltaUV2.y * edge1.y - deltaUV1.y * edge2.y);
-        cube.vertices[triIndices[0]].tangent.z = f * (deltaUV2.y * edge1.z - deltaUV1.y * edge2.z);
-        cube.vertices[triIndices[1]].tangent = cube.vertices[triIndices[0]].tangent;
-        cube.vertices[triIndices[2]].tangent = cube.vertices[triIndices[0]].tangent;
-
-        cube.vertices[triIndices[0]].bitangent.x = f * (-deltaUV2.x * edge1.x + deltaUV1.x * edge2.x);
-        cube.vertices[triIndices[0]].bitangent.y = f * (-deltaUV2.x * edge1.y + deltaUV1.x * edge2.y);
-        cube.vertices[triIndices[0]].bitangent.z = f * (-deltaUV2.x * edge1.z + deltaUV1.x * edge2.z);
-        cube.vertices[triIndices[1]].bitangent = cube.vertices[triIndices[0]].bitangent;
-        cube.vertices[triIndices[2]].bitangent = cube.vertices[triIndices[0]].bitangent;
-    }
+    GenerateTangents(cube);
     return cube;
 }
 Mesh GenerateSphere(float scale, glm::vec3 offset)
@@ -176,23 +130,7 @@ Mesh GenerateSphere(float scale, glm::vec3 offset)
         }
         oddRow = !oddRow;
     }
-    std::size_t indexCount_ = mesh.indices.size();
-    for (size_t i = 0; i < indexCount_ - 2; i++)
-    {
-        const glm::vec3 edge1 = mesh.vertices[mesh.indices[i + 1]].position - mesh.vertices[mesh.indices[i]].position;
-        const glm::vec3 edge2 = mesh.vertices[mesh.indices[i + 2]].position - mesh.vertices[mesh.indices[i]].position;
-        const glm::vec2 deltaUV1 = mesh.vertices[mesh.indices[i + 1]].texCoords - mesh.vertices[mesh.indices[i]].texCoords;
-        const glm::vec2 deltaUV2 = mesh.vertices[mesh.indices[i + 2]].texCoords - mesh.vertices[mesh.indices[i]].texCoords;
-
-        const float f = 1.0f / (deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y);
-        mesh.vertices[mesh.indices[i]].tangent.x = f * (deltaUV2.y * edge1.x - deltaUV1.y * edge2.x);
-        mesh.vertices[mesh.indices[i]].tangent.y = f * (deltaUV2.y * edge1.y - deltaUV1.y * edge2.y);
-        mesh.vertices[mesh.indices[i]].tangent.z = f * (deltaUV2.y * edge1.z - deltaUV1.y * edge2.z);
-
-        mesh.vertices[mesh.indices[i]].bitangent.x = f * (-deltaUV2.x * edge1.x + deltaUV1.x * edge2.x);
-        mesh.vertices[mesh.indices[i]].bitangent.y = f * (-deltaUV2.x * edge1.y + deltaUV1.x * edge2.y);
-        mesh.vertices[mesh.indices[i]].bitangent.z = f * (-deltaUV2.x * edge1.z + deltaUV1.x * edge2.z);
-    }
+    GenerateTangents(mesh, MeshTopology::TRIANGLE_STRIP);
     return mesh;
 }
 
@@ -0,0 +1,150 @@
+#include "renderer/mesh_streams.h"
+
+#include "utils/parallel.h"
+
+#include <glm/common.hpp>
+
+#include <algorithm>
+#include <array>
+
+#if defined(__AVX__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#ifdef TRACY_ENABLE
+#include <tracy/Tracy.hpp>
+#endif
+
+namespace core
+{
+
+namespace
+{
+constexpr std::size_t MESH_STREAMS_GRAIN = 16 * 1024;
+static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "the position stream is read as contiguous floats");
+
+MeshBounds ComputeChunkBounds(const glm::vec3* positions, std::size_t count)
+{
+    MeshBounds bounds{ positions[0], positions[0] };
+    std::size_t i = 0;
+#if defined(__AVX__) || defined(__AVX2__)
+    // 8 positions are 24 floats, three registers whose lanes always hold the same components
+    if (count >= 8)
+    {
+        const float* data = &positions[0].x;
+        __m256 minimums[3] = { _mm256_loadu_ps(data), _mm256_loadu_ps(data + 8), _mm256_loadu_ps(data + 16) };
+        __m256 maximums[3] = { minimums[0], minimums[1], minimums[2] };
+        for (i = 8; i + 8 <= count; i += 8)
+        {
+            const float* block = data + 3 * i;
+            for (std::size_t j = 0; j < 3; j++)
+            {
+                const auto values = _mm256_loadu_ps(block + 8 * j);
+                minimums[j] = _mm256_min_ps(minimums[j], values);
+                maximums[j] = _mm256_max_ps(maximums[j], values);
+            }
+        }
+        alignas(32) std::array<float, 24> minimumLanes{};
+        alignas(32) std::array<float, 24> maximumLanes{};
+        for (std::size_t j = 0; j < 3; j++)
+        {
+            _mm256_store_ps(minimumLanes.data() + 8 * j, minimums[j]);
+            _mm256_store_ps(maximumLanes.data() + 8 * j, maximums[j]);
+        }
+        for (std::size_t lane = 0; lane < minimumLanes.size(); lane++)
+        {
+            const auto component = static_cast<glm::length_t>(lane % 3);
+            bounds.min[component] = std::min(bounds.min[component], minimumLanes[lane]);
+            bounds.max[component] = std::max(bounds.max[component], maximumLanes[lane]);
+        }
+    }
+#endif
+    for (; i < count; i++)
+    {
+        bounds.min = glm::min(bounds.min, positions[i]);
+        bounds.max = glm::max(bounds.max, positions[i]);
+    }
+    return bounds;
+}
+}
+
+void MeshStreams::Resize(std::size_t vertexCount)
+{
+    positions.resize(vertexCount);
+    texCoords.resize(vertexCount);
+    normals.resize(vertexCount);
+    tangents.resize(vertexCount);
+    bitangents.resize(vertexCount);
+}
+
+MeshStreams SplitMesh(const Mesh& mesh)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    MeshStreams streams;
+    streams.Resize(mesh.vertices.size());
+    ParallelForRange(0, mesh.vertices.size(), MESH_STREAMS_GRAIN, [&streams, &mesh](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; i++)
+        {
+            const auto& vertex = mesh.vertices[i];
+            streams.positions[i] = vertex.position;
+            streams.texCoords[i] = vertex.texCoords;
+            streams.normals[i] = vertex.normal;
+            streams.tangents[i] = vertex.tangent;
+            streams.bitangents[i] = vertex.bitangent;
+        }
+    });
+    streams.indices = mesh.indices;
+    return streams;
+}
+
+void InterleaveMesh(const MeshStreams& streams, Mesh& mesh)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    const auto vertexCount = streams.GetVertexCount();
+    mesh.vertices.resize(vertexCount);
+    ParallelForRange(0, vertexCount, MESH_STREAMS_GRAIN, [&streams, &mesh](std::size_t begin, std::size_t end)
+    {
+        // a missing stream is left at zero
+        for (std::size_t i = begin; i < end; i++)
+        {
+            auto& vertex = mesh.vertices[i];
+            vertex.position = streams.positions[i];
+            vertex.texCoords = i < streams.texCoords.size() ? streams.texCoords[i] : glm::vec2(0.0f);
+            vertex.normal = i < streams.normals.size() ? streams.normals[i] : glm::vec3(0.0f);
+            vertex.tangent = i < streams.tangents.size() ? streams.tangents[i] : glm::vec3(0.0f);
+            vertex.bitangent = i < streams.bitangents.size() ? streams.bitangents[i] : glm::vec3(0.0f);
+        }
+    });
+    mesh.indices = streams.indices;
+}
+
+MeshBounds ComputeBounds(std::span<const glm::vec3> positions)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    if (positions.empty())
+    {
+        return {};
+    }
+    const auto chunkCount = (positions.size() + MESH_STREAMS_GRAIN - 1) / MESH_STREAMS_GRAIN;
+    std::vector<MeshBounds> chunkBounds(chunkCount);
+    ParallelForRange(0, positions.size(), MESH_STREAMS_GRAIN, [&positions, &chunkBounds](std::size_t begin, std::size_t end)
+    {
+        chunkBounds[begin / MESH_STREAMS_GRAIN] = ComputeChunkBounds(positions.data() + begin, end - begin);
+    });
+    auto bounds = chunkBounds.front();
+    for (const auto& chunk : chunkBounds)
+    {
+        bounds.min = glm::min(bounds.min, chunk.min);
+        bounds.max = glm::max(bounds.max, chunk.max);
+    }
+    return bounds;
+}
+
+} // namespace core
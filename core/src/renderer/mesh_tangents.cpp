@@ -0,0 +1,279 @@
+#include "renderer/mesh_tangents.h"
+
+#include "utils/parallel.h"
+
+#include <glm/geometric.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#ifdef TRACY_ENABLE
+#include <tracy/Tracy.hpp>
+#endif
+
+namespace core
+{
+
+namespace
+{
+constexpr std::size_t TANGENT_TRIANGLE_GRAIN = 8 * 1024;
+constexpr std::size_t TANGENT_VERTEX_GRAIN = 16 * 1024;
+constexpr float MIN_TANGENT_LENGTH = 1.0e-8f;
+static_assert(sizeof(glm::vec2) == 2 * sizeof(float), "the texture coordinates stream is gathered as floats");
+static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "the position stream is gathered as floats");
+
+/**
+ * @brief TriangleTangents holds the unnormalized tangent and bitangent of each triangle, one stream per component
+ */
+struct TriangleTangents
+{
+    std::vector<float> tangentX, tangentY, tangentZ;
+    std::vector<float> bitangentX, bitangentY, bitangentZ;
+
+    explicit TriangleTangents(std::size_t triangleCount) :
+        tangentX(triangleCount), tangentY(triangleCount), tangentZ(triangleCount),
+        bitangentX(triangleCount), bitangentY(triangleCount), bitangentZ(triangleCount)
+    {
+    }
+};
+
+/**
+ * @brief GetStripTriangles returns the triangle list of a triangle strip, every other triangle is flipped
+ * to keep the winding, the degenerate triangles joining the rows are kept as they have no area
+ */
+std::vector<unsigned> GetStripTriangles(std::span<const unsigned> strip)
+{
+    std::vector<unsigned> triangles;
+    if (strip.size() < 3)
+    {
+        return triangles;
+    }
+    triangles.reserve((strip.size() - 2) * 3);
+    for (std::size_t i = 0; i + 2 < strip.size(); i++)
+    {
+        const bool odd = i % 2 == 1;
+        triangles.push_back(strip[i]);
+        triangles.push_back(strip[odd ? i + 2 : i + 1]);
+        triangles.push_back(strip[odd ? i + 1 : i + 2]);
+    }
+    return triangles;
+}
+
+/**
+ * @brief ComputeTriangleTangent solves the tangent and bitangent without dividing by the uv determinant,
+ * only its sign is kept, so the length of the result is proportional to the area of the triangle,
+ * and a triangle without uv area gives zero
+ */
+void ComputeTriangleTangent(const MeshStreams& streams, const unsigned* triangle, TriangleTangents& out, std::size_t index)
+{
+    const auto& p0 = streams.positions[triangle[0]];
+    const auto& uv0 = streams.texCoords[triangle[0]];
+    const auto edge1 = streams.positions[triangle[1]] - p0;
+    const auto edge2 = streams.positions[triangle[2]] - p0;
+    const auto deltaUv1 = streams.texCoords[triangle[1]] - uv0;
+    const auto deltaUv2 = streams.texCoords[triangle[2]] - uv0;
+    const float determinant = deltaUv1.x * deltaUv2.y - deltaUv2.x * deltaUv1.y;
+    const float sign = determinant > 0.0f ? 1.0f : (determinant < 0.0f ? -1.0f : 0.0f);
+    const auto tangent = (edge1 * deltaUv2.y - edge2 * deltaUv1.y) * sign;
+    const auto bitangent = (edge2 * deltaUv1.x - edge1 * deltaUv2.x) * sign;
+    out.tangentX[index] = tangent.x;
+    out.tangentY[index] = tangent.y;
+    out.tangentZ[index] = tangent.z;
+    out.bitangentX[index] = bitangent.x;
+    out.bitangentY[index] = bitangent.y;
+    out.bitangentZ[index] = bitangent.z;
+}
+
+#if defined(__AVX2__)
+/**
+ * @brief ComputeTriangleTangents8 is ComputeTriangleTangent for 8 consecutive triangles, one per lane
+ */
+void ComputeTriangleTangents8(const MeshStreams& streams, const unsigned* triangles, TriangleTangents& out, std::size_t index)
+{
+    const auto* positions = &streams.positions[0].x;
+    const auto* texCoords = &streams.texCoords[0].x;
+    const auto* indices = reinterpret_cast<const int*>(triangles);
+    const auto triangleOffsets = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+
+    __m256 positionX[3], positionY[3], positionZ[3], texCoordU[3], texCoordV[3];
+    for (int corner = 0; corner < 3; corner++)
+    {
+        const auto vertices = _mm256_i32gather_epi32(indices + corner, triangleOffsets, 4);
+        const auto positionOffsets = _mm256_add_epi32(vertices, _mm256_add_epi32(vertices, vertices));
+        const auto texCoordOffsets = _mm256_add_epi32(vertices, vertices);
+        positionX[corner] = _mm256_i32gather_ps(positions, positionOffsets, 4);
+        positionY[corner] = _mm256_i32gather_ps(positions + 1, positionOffsets, 4);
+        positionZ[corner] = _mm256_i32gather_ps(positions + 2, positionOffsets, 4);
+        texCoordU[corner] = _mm256_i32gather_ps(texCoords, texCoordOffsets, 4);
+        texCoordV[corner] = _mm256_i32gather_ps(texCoords + 1, texCoordOffsets, 4);
+    }
+    const auto edge1X = _mm256_sub_ps(positionX[1], positionX[0]);
+    const auto edge1Y = _mm256_sub_ps(positionY[1], positionY[0]);
+    const auto edge1Z = _mm256_sub_ps(positionZ[1], positionZ[0]);
+    const auto edge2X = _mm256_sub_ps(positionX[2], positionX[0]);
+    const auto edge2Y = _mm256_sub_ps(positionY[2], positionY[0]);
+    const auto edge2Z = _mm256_sub_ps(positionZ[2], positionZ[0]);
+    const auto deltaU1 = _mm256_sub_ps(texCoordU[1], texCoordU[0]);
+    const auto deltaV1 = _mm256_sub_ps(texCoordV[1], texCoordV[0]);
+    const auto deltaU2 = _mm256_sub_ps(texCoordU[2], texCoordU[0]);
+    const auto deltaV2 = _mm256_sub_ps(texCoordV[2], texCoordV[0]);
+
+    // sign of the determinant: +-1 copied from its sign bit, masked to zero when the determinant is zero
+    const auto determinant = _mm256_sub_ps(_mm256_mul_ps(deltaU1, deltaV2), _mm256_mul_ps(deltaU2, deltaV1));
+    const auto zero = _mm256_setzero_ps();
+    const auto signBit = _mm256_and_ps(determinant, _mm256_set1_ps(-0.0f));
+    const auto sign = _mm256_and_ps(_mm256_or_ps(signBit, _mm256_set1_ps(1.0f)),
+                                    _mm256_cmp_ps(determinant, zero, _CMP_NEQ_OQ));
+
+    const auto tangentScale1 = _mm256_mul_ps(deltaV2, sign);
+    const auto tangentScale2 = _mm256_mul_ps(deltaV1, sign);
+    const auto bitangentScale1 = _mm256_mul_ps(deltaU2, sign);
+    const auto bitangentScale2 = _mm256_mul_ps(deltaU1, sign);
+    _mm256_storeu_ps(out.tangentX.data() + index, _mm256_fmsub_ps(edge1X, tangentScale1, _mm256_mul_ps(edge2X, tangentScale2)));
+    _mm256_storeu_ps(out.tangentY.data() + index, _mm256_fmsub_ps(edge1Y, tangentScale1, _mm256_mul_ps(edge2Y, tangentScale2)));
+    _mm256_storeu_ps(out.tangentZ.data() + index, _mm256_fmsub_ps(edge1Z, tangentScale1, _mm256_mul_ps(edge2Z, tangentScale2)));
+    _mm256_storeu_ps(out.bitangentX.data() + index, _mm256_fmsub_ps(edge2X, bitangentScale2, _mm256_mul_ps(edge1X, bitangentScale1)));
+    _mm256_storeu_ps(out.bitangentY.data() + index, _mm256_fmsub_ps(edge2Y, bitangentScale2, _mm256_mul_ps(edge1Y, bitangentScale1)));
+    _mm256_storeu_ps(out.bitangentZ.data() + index, _mm256_fmsub_ps(edge2Z, bitangentScale2, _mm256_mul_ps(edge1Z, bitangentScale1)));
+}
+#endif
+
+TriangleTangents ComputeTriangleTangents(const MeshStreams& streams, std::span<const unsigned> triangles)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    const auto triangleCount = triangles.size() / 3;
+    TriangleTangents triangleTangents(triangleCount);
+    ParallelForRange(0, triangleCount, TANGENT_TRIANGLE_GRAIN, [&](std::size_t begin, std::size_t end)
+    {
+        std::size_t i = begin;
+#if defined(__AVX2__)
+        for (; i + 8 <= end; i += 8)
+        {
+            ComputeTriangleTangents8(streams, triangles.data() + 3 * i, triangleTangents, i);
+        }
+#endif
+        for (; i < end; i++)
+        {
+            ComputeTriangleTangent(streams, triangles.data() + 3 * i, triangleTangents, i);
+        }
+    });
+    return triangleTangents;
+}
+
+/**
+ * @brief VertexTriangles lists the triangles of each vertex, those of vertex v are
+ * triangles[offsets[v]] to triangles[offsets[v + 1]], in triangle order so the sums do not depend on the threads
+ */
+struct VertexTriangles
+{
+    std::vector<unsigned> offsets;
+    std::vector<unsigned> triangles;
+};
+
+VertexTriangles GetVertexTriangles(std::span<const unsigned> triangles, std::size_t vertexCount)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    VertexTriangles vertexTriangles;
+    vertexTriangles.offsets.assign(vertexCount + 1, 0);
+    for (const auto vertex : triangles)
+    {
+        vertexTriangles.offsets[vertex + 1]++;
+    }
+    for (std::size_t i = 1; i < vertexTriangles.offsets.size(); i++)
+    {
+        vertexTriangles.offsets[i] += vertexTriangles.offsets[i - 1];
+    }
+    vertexTriangles.triangles.resize(triangles.size());
+    std::vector<unsigned> cursors(vertexTriangles.offsets.begin(), vertexTriangles.offsets.end() - 1);
+    for (std::size_t i = 0; i < triangles.size(); i++)
+    {
+        vertexTriangles.triangles[cursors[triangles[i]]++] = static_cast<unsigned>(i / 3);
+    }
+    return vertexTriangles;
+}
+
+/**
+ * @brief GetPerpendicular returns a unit vector perpendicular to the normal, for the vertices without uv gradient
+ */
+glm::vec3 GetPerpendicular(const glm::vec3& normal)
+{
+    const auto axis = std::abs(normal.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+    const auto perpendicular = glm::cross(normal, axis);
+    const auto length = glm::length(perpendicular);
+    return length > MIN_TANGENT_LENGTH ? perpendicular / length : axis;
+}
+}
+
+void GenerateTangents(MeshStreams& streams, MeshTopology topology)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    const auto vertexCount = streams.GetVertexCount();
+    streams.tangents.assign(vertexCount, glm::vec3(0.0f));
+    streams.bitangents.assign(vertexCount, glm::vec3(0.0f));
+    if (vertexCount == 0 || streams.texCoords.size() != vertexCount || streams.normals.size() != vertexCount)
+    {
+        return;
+    }
+
+    std::vector<unsigned> stripTriangles;
+    std::span<const unsigned> triangles = streams.indices;
+    if (topology == MeshTopology::TRIANGLE_STRIP)
+    {
+        stripTriangles = GetStripTriangles(streams.indices);
+        triangles = stripTriangles;
+    }
+    triangles = triangles.first(triangles.size() - triangles.size() % 3);
+    for (const auto vertex : triangles)
+    {
+        if (vertex >= vertexCount)
+        {
+            return;
+        }
+    }
+
+    const auto triangleTangents = ComputeTriangleTangents(streams, triangles);
+    const auto vertexTriangles = GetVertexTriangles(triangles, vertexCount);
+    ParallelForRange(0, vertexCount, TANGENT_VERTEX_GRAIN, [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t v = begin; v < end; v++)
+        {
+            glm::vec3 tangent{ 0.0f };
+            glm::vec3 bitangent{ 0.0f };
+            for (auto i = vertexTriangles.offsets[v]; i < vertexTriangles.offsets[v + 1]; i++)
+            {
+                const auto triangle = vertexTriangles.triangles[i];
+                tangent += glm::vec3(triangleTangents.tangentX[triangle], triangleTangents.tangentY[triangle], triangleTangents.tangentZ[triangle]);
+                bitangent += glm::vec3(triangleTangents.bitangentX[triangle], triangleTangents.bitangentY[triangle], triangleTangents.bitangentZ[triangle]);
+            }
+            // Gram-Schmidt against the normal, the bitangent is rebuilt from the tangent with its handedness
+            const auto& normal = streams.normals[v];
+            tangent -= normal * glm::dot(normal, tangent);
+            const auto length = glm::length(tangent);
+            tangent = length > MIN_TANGENT_LENGTH ? tangent / length : GetPerpendicular(normal);
+            const auto orthogonal = glm::cross(normal, tangent);
+            streams.tangents[v] = tangent;
+            streams.bitangents[v] = glm::dot(orthogonal, bitangent) < 0.0f ? -orthogonal : orthogonal;
+        }
+    });
+}
+
+void GenerateTangents(Mesh& mesh, MeshTopology topology)
+{
+    auto streams = SplitMesh(mesh);
+    GenerateTangents(streams, topology);
+    InterleaveMesh(streams, mesh);
+}
+
+} // namespace core
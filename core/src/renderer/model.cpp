@@ -1,11 +1,21 @@
 #include "renderer/model.h"
 
 #include "engine/filesystem.h"
+#include "renderer/mesh_streams.h"
+#include "renderer/mesh_tangents.h"
+#include "utils/hash.h"
 #include "utils/log.h"
+#include "utils/parallel.h"
 
 #include <assimp/postprocess.h>
 #include <fmt/format.h>
 
+#include <glm/common.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <limits>
+
 #ifdef TRACY_ENABLE
 #include <tracy/Tracy.hpp>
 #endif
@@ -13,6 +23,65 @@
 namespace core
 {
 
+namespace
+{
+// the tangents are generated by GenerateTangents from the streams, not by assimp
+constexpr unsigned MODEL_IMPORT_FLAGS = aiProcess_Triangulate | aiProcess_GenNormals | aiProcess_FlipUVs;
+static_assert(sizeof(aiVector3D) == sizeof(glm::vec3), "the aiMesh streams are copied as glm::vec3");
+// to increment when the serialized model changes, so the AssetCache entries of the previous version are not used
+constexpr int MODEL_CACHE_VERSION = 3;
+
+std::uint64_t AlignModelFileOffset(std::uint64_t offset)
+{
+    return (offset + MODEL_FILE_ALIGNMENT - 1) & ~(MODEL_FILE_ALIGNMENT - 1);
+}
+
+/**
+ * @brief IsInFile checks that count elements of elementSize bytes at offset are inside the file
+ */
+bool IsInFile(std::span<const unsigned char> data, std::uint64_t offset, std::uint64_t count, std::uint64_t elementSize)
+{
+    return offset <= data.size() && count <= (data.size() - offset) / elementSize;
+}
+
+/**
+ * @brief HashMaterialLibraries hashes the content of the material libraries referenced by the mtllib lines of an obj
+ * file, looked up next to it like assimp does, so editing them changes the cache key of the model
+ */
+std::uint64_t HashMaterialLibraries(const FilesystemInterface& filesystem, std::string_view modelPath, std::string_view modelContent)
+{
+    std::uint64_t hash = 0;
+    if (!modelPath.ends_with(".obj"))
+    {
+        return hash;
+    }
+    constexpr std::string_view whitespaces = " \t\r";
+    constexpr std::string_view materialLibraryKeyword = "mtllib";
+    const auto modelDirectory = std::filesystem::path(modelPath).parent_path();
+    while (!modelContent.empty())
+    {
+        const auto lineEnd = modelContent.find('\n');
+        auto line = modelContent.substr(0, lineEnd);
+        modelContent.remove_prefix(lineEnd == std::string_view::npos ? modelContent.size() : lineEnd + 1);
+        line.remove_prefix(std::min(line.find_first_not_of(whitespaces), line.size()));
+        if (!line.starts_with(materialLibraryKeyword) || line.size() == materialLibraryKeyword.size() ||
+            whitespaces.find(line[materialLibraryKeyword.size()]) == std::string_view::npos)
+        {
+            continue;
+        }
+        line.remove_prefix(materialLibraryKeyword.size());
+        line.remove_prefix(std::min(line.find_first_not_of(whitespaces), line.size()));
+        line = line.substr(0, line.find_last_not_of(whitespaces) + 1);
+        const Path materialLibraryPath((modelDirectory / line).generic_string());
+        // a missing library still changes the key, the model gets its materials once the library is added
+        const auto materialLibrary = filesystem.FileExists(materialLibraryPath) ?
+            filesystem.LoadFile(materialLibraryPath) : FileBuffer{};
+        hash = HashBytes(materialLibrary.data, materialLibrary.size, HashBytes(line.data(), line.size(), hash));
+    }
+    return hash;
+}
+}
+
 const Mesh& Model::GetMesh(std::string_view meshName)
 {
     const auto it = std::ranges::find_if(meshes_, [&meshName](const auto& mesh)
@@ -28,13 +97,25 @@ void Model::LoadFromNode(const aiScene* scene, const aiNode* node)
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
+    // the meshes are listed in the order of the node tree first, so their order does not depend on the tasks
+    std::vector<const aiMesh*> aiMeshes;
+    CollectNodeMeshes(scene, node, aiMeshes);
+    meshes_.resize(aiMeshes.size());
+    ParallelFor(0, aiMeshes.size(), 1, [this, &aiMeshes](std::size_t i)
+    {
+        LoadMesh(aiMeshes[i], meshes_[i]);
+    });
+}
+
+void Model::CollectNodeMeshes(const aiScene* scene, const aiNode* node, std::vector<const aiMesh*>& aiMeshes)
+{
     for(unsigned i = 0; i < node->mNumMeshes; i++)
     {
-        LoadMesh(scene->mMeshes[node->mMeshes[i]]);
+        aiMeshes.push_back(scene->mMeshes[node->mMeshes[i]]);
     }
     for(unsigned i = 0; i < node->mNumChildren; i++)
     {
-        LoadFromNode(scene, node->mChildren[i]);
+        CollectNodeMeshes(scene, node->mChildren[i], aiMeshes);
     }
 }
 
@@ -67,54 +148,202 @@ void Model::LoadMaterials(const aiScene* scene)
     }
 }
 
-void Model::LoadMesh(const aiMesh* aiMesh)
+void Model::LoadMesh(const aiMesh* aiMesh, Mesh& mesh)
 {
 
 #ifdef TRACY_ENABLE
     ZoneScoped;
 #endif
-    Mesh mesh;
     mesh.name = aiMesh->mName.C_Str();
     mesh.materialIndex = aiMesh->mMaterialIndex;
-    mesh.vertices.reserve(aiMesh->mNumVertices);
 
-    for(unsigned i = 0; i < aiMesh->mNumVertices; i++)
+    // the aiMesh vertices are already in streams, the float3 ones are copied as a whole
+    const std::size_t vertexCount = aiMesh->mNumVertices;
+    MeshStreams streams;
+    auto copyStream = [vertexCount](const aiVector3D* source, std::vector<glm::vec3>& stream)
     {
-        Vertex vertex{};
-        const auto& v = aiMesh->mVertices[i];
-        vertex.position = { v.x, v.y, v.z };
-
-        const auto& texCoords = aiMesh->mTextureCoords[0][i];
-        vertex.texCoords = { texCoords.x, texCoords.y };
-
-        const auto& normal = aiMesh->mNormals[i];
-        vertex.normal = { normal.x, normal.y, normal.z };
-
-        const auto& tangent = aiMesh->mTangents[i];
-        vertex.tangent = { tangent.x, tangent.y, tangent.z };
-
-        const auto& bitangent = aiMesh->mBitangents[i];
-        vertex.bitangent = { bitangent.x, bitangent.y, bitangent.z };
-
-        mesh.vertices.push_back(vertex);
+        stream.resize(vertexCount);
+        if (source != nullptr)
+        {
+            std::memcpy(stream.data(), source, vertexCount * sizeof(glm::vec3));
+        }
+    };
+    copyStream(aiMesh->mVertices, streams.positions);
+    copyStream(aiMesh->mNormals, streams.normals);
+    streams.texCoords.resize(vertexCount);
+    if (aiMesh->HasTextureCoords(0))
+    {
+        ParallelFor(0, vertexCount, 4096, [&streams, aiMesh](std::size_t i)
+        {
+            const auto& texCoords = aiMesh->mTextureCoords[0][i];
+            streams.texCoords[i] = { texCoords.x, texCoords.y };
+        });
     }
 
-    mesh.indices.reserve(aiMesh->mNumFaces * 3u);
+    streams.indices.reserve(aiMesh->mNumFaces * 3u);
     for(unsigned i = 0; i < aiMesh->mNumFaces; i++)
     {
         const auto& face = aiMesh->mFaces[i];
         for(unsigned j = 0; j < face.mNumIndices; j++)
         {
-            mesh.indices.push_back(face.mIndices[j]);
+            streams.indices.push_back(face.mIndices[j]);
         }
     }
-    meshes_.push_back(mesh);
 
+    GenerateTangents(streams);
+    const auto bounds = ComputeBounds(streams.positions);
+    mesh.boundsMin = bounds.min;
+    mesh.boundsMax = bounds.max;
+    InterleaveMesh(streams, mesh);
 }
 
-ModelManager::ModelManager()
+std::string Model::Serialize() const
 {
-    importer_.SetIOHandler(new IOSystem());
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    ModelFileHeader header{};
+    header.magic = MODEL_FILE_MAGIC;
+    header.version = MODEL_FILE_VERSION;
+    header.meshCount = static_cast<std::uint32_t>(meshes_.size());
+    header.materialCount = static_cast<std::uint32_t>(materials_.size());
+    header.meshesOffset = sizeof(ModelFileHeader);
+    header.materialsOffset = header.meshesOffset + meshes_.size() * sizeof(ModelFileMesh);
+    header.stringsOffset = header.materialsOffset + materials_.size() * sizeof(ModelFileMaterial);
+
+    std::string strings;
+    auto addString = [&strings](std::string_view str)
+    {
+        const ModelFileString fileString{ static_cast<std::uint32_t>(strings.size()), static_cast<std::uint32_t>(str.size()) };
+        strings.append(str);
+        return fileString;
+    };
+    std::vector<ModelFileMaterial> fileMaterials(materials_.size());
+    for (std::size_t i = 0; i < materials_.size(); i++)
+    {
+        fileMaterials[i].name = addString(materials_[i].name);
+        for (std::size_t j = 0; j < materials_[i].textures.size(); j++)
+        {
+            fileMaterials[i].textures[j] = addString(materials_[i].textures[j]);
+        }
+    }
+    std::vector<ModelFileMesh> fileMeshes(meshes_.size());
+    for (std::size_t i = 0; i < meshes_.size(); i++)
+    {
+        fileMeshes[i].name = addString(meshes_[i].name);
+    }
+
+    glm::vec3 boundsMin{ std::numeric_limits<float>::max() };
+    glm::vec3 boundsMax{ std::numeric_limits<float>::lowest() };
+    auto offset = AlignModelFileOffset(header.stringsOffset + strings.size());
+    for (std::size_t i = 0; i < meshes_.size(); i++)
+    {
+        const auto& mesh = meshes_[i];
+        auto& fileMesh = fileMeshes[i];
+        fileMesh.materialIndex = mesh.materialIndex;
+        fileMesh.verticesOffset = offset;
+        fileMesh.vertexCount = mesh.vertices.size();
+        offset = AlignModelFileOffset(offset + mesh.vertices.size() * sizeof(Vertex));
+        fileMesh.indicesOffset = offset;
+        fileMesh.indexCount = mesh.indices.size();
+        offset = AlignModelFileOffset(offset + mesh.indices.size() * sizeof(unsigned));
+        fileMesh.boundsMin = { mesh.boundsMin.x, mesh.boundsMin.y, mesh.boundsMin.z };
+        fileMesh.boundsMax = { mesh.boundsMax.x, mesh.boundsMax.y, mesh.boundsMax.z };
+        boundsMin = glm::min(boundsMin, mesh.boundsMin);
+        boundsMax = glm::max(boundsMax, mesh.boundsMax);
+    }
+    if (!meshes_.empty())
+    {
+        header.boundsMin = { boundsMin.x, boundsMin.y, boundsMin.z };
+        header.boundsMax = { boundsMax.x, boundsMax.y, boundsMax.z };
+    }
+    header.fileSize = offset;
+
+    std::string out(offset, '\0');
+    std::memcpy(out.data(), &header, sizeof(header));
+    std::memcpy(out.data() + header.meshesOffset, fileMeshes.data(), fileMeshes.size() * sizeof(ModelFileMesh));
+    std::memcpy(out.data() + header.materialsOffset, fileMaterials.data(), fileMaterials.size() * sizeof(ModelFileMaterial));
+    std::memcpy(out.data() + header.stringsOffset, strings.data(), strings.size());
+    for (std::size_t i = 0; i < meshes_.size(); i++)
+    {
+        const auto& mesh = meshes_[i];
+        std::memcpy(out.data() + fileMeshes[i].verticesOffset, mesh.vertices.data(), mesh.vertices.size() * sizeof(Vertex));
+        std::memcpy(out.data() + fileMeshes[i].indicesOffset, mesh.indices.data(), mesh.indices.size() * sizeof(unsigned));
+    }
+    return out;
+}
+
+bool Model::Deserialize(std::span<const unsigned char> data)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    ModelFileHeader header{};
+    if (data.size() < sizeof(header))
+    {
+        return false;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != MODEL_FILE_MAGIC || header.version != MODEL_FILE_VERSION || header.fileSize > data.size() ||
+        !IsInFile(data, header.meshesOffset, header.meshCount, sizeof(ModelFileMesh)) ||
+        !IsInFile(data, header.materialsOffset, header.materialCount, sizeof(ModelFileMaterial)) ||
+        header.stringsOffset > data.size())
+    {
+        return false;
+    }
+    const auto strings = data.subspan(header.stringsOffset);
+    auto readString = [&strings](const ModelFileString& fileString, std::string& str)
+    {
+        if (!IsInFile(strings, fileString.offset, fileString.length, 1))
+        {
+            return false;
+        }
+        str.assign(reinterpret_cast<const char*>(strings.data() + fileString.offset), fileString.length);
+        return true;
+    };
+
+    std::vector<ModelFileMaterial> fileMaterials(header.materialCount);
+    std::memcpy(fileMaterials.data(), data.data() + header.materialsOffset, fileMaterials.size() * sizeof(ModelFileMaterial));
+    materials_.resize(header.materialCount);
+    for (std::size_t i = 0; i < fileMaterials.size(); i++)
+    {
+        if (!readString(fileMaterials[i].name, materials_[i].name))
+        {
+            return false;
+        }
+        for (std::size_t j = 0; j < materials_[i].textures.size(); j++)
+        {
+            if (!readString(fileMaterials[i].textures[j], materials_[i].textures[j]))
+            {
+                return false;
+            }
+        }
+    }
+
+    std::vector<ModelFileMesh> fileMeshes(header.meshCount);
+    std::memcpy(fileMeshes.data(), data.data() + header.meshesOffset, fileMeshes.size() * sizeof(ModelFileMesh));
+    meshes_.resize(header.meshCount);
+    for (std::size_t i = 0; i < fileMeshes.size(); i++)
+    {
+        const auto& fileMesh = fileMeshes[i];
+        auto& mesh = meshes_[i];
+        if (!readString(fileMesh.name, mesh.name) ||
+            !IsInFile(data, fileMesh.verticesOffset, fileMesh.vertexCount, sizeof(Vertex)) ||
+            !IsInFile(data, fileMesh.indicesOffset, fileMesh.indexCount, sizeof(unsigned)))
+        {
+            return false;
+        }
+        mesh.materialIndex = fileMesh.materialIndex;
+        mesh.boundsMin = { fileMesh.boundsMin[0], fileMesh.boundsMin[1], fileMesh.boundsMin[2] };
+        mesh.boundsMax = { fileMesh.boundsMax[0], fileMesh.boundsMax[1], fileMesh.boundsMax[2] };
+        // the arrays are copied as a whole, Vertex is stored as is in the file.
+        // A file inside a pack is not always aligned, so the arrays are not read in place
+        mesh.vertices.resize(fileMesh.vertexCount);
+        std::memcpy(mesh.vertices.data(), data.data() + fileMesh.verticesOffset, fileMesh.vertexCount * sizeof(Vertex));
+        mesh.indices.resize(fileMesh.indexCount);
+        std::memcpy(mesh.indices.data(), data.data() + fileMesh.indicesOffset, fileMesh.indexCount * sizeof(unsigned));
+    }
+    return true;
 }
 
 ModelIndex ModelManager::ImportModel(const core::Path &modelPath)
@@ -129,44 +358,132 @@ ModelIndex ModelManager::ImportModel(const core::Path &modelPath)
     {
         return it->second;
     }
+    Model model;
+    if (!LoadModel(modelPath, model))
+    {
+        return INVALID_MODEL_INDEX;
+    }
+    const auto modelIndex = AddModel(std::move(model));
+    modelNamesMap_[modelPath.c_str()] = modelIndex;
+    return modelIndex;
+}
 
+std::vector<ModelIndex> ModelManager::ImportModels(std::span<const core::Path> modelPaths)
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    // each model file not imported yet is loaded once, by its own task
+    std::vector<std::size_t> newPathIndices;
+    std::unordered_map<std::string_view, std::size_t> newPathsMap;
+    for (std::size_t i = 0; i < modelPaths.size(); i++)
+    {
+        const std::string_view modelPath = modelPaths[i];
+        if (!modelNamesMap_.contains(modelPaths[i].c_str()) && !newPathsMap.contains(modelPath))
+        {
+            newPathsMap[modelPath] = i;
+            newPathIndices.push_back(i);
+        }
+    }
+    std::vector<Model> newModels(newPathIndices.size());
+    std::vector<unsigned char> hasLoaded(newPathIndices.size(), false);
+    ParallelFor(0, newPathIndices.size(), 1, [&](std::size_t i)
+    {
+        hasLoaded[i] = LoadModel(modelPaths[newPathIndices[i]], newModels[i]);
+    });
+    // added in the order of the paths, whichever task finished first
+    for (std::size_t i = 0; i < newPathIndices.size(); i++)
+    {
+        if (hasLoaded[i])
+        {
+            modelNamesMap_[modelPaths[newPathIndices[i]].c_str()] = AddModel(std::move(newModels[i]));
+        }
+    }
+
+    std::vector<ModelIndex> modelIndices;
+    modelIndices.reserve(modelPaths.size());
+    for (const auto& modelPath : modelPaths)
+    {
+        const auto it = modelNamesMap_.find(modelPath.c_str());
+        modelIndices.push_back(it != modelNamesMap_.end() ? it->second : INVALID_MODEL_INDEX);
+    }
+    return modelIndices;
+}
+
+bool ModelManager::LoadModel(const core::Path &modelPath, Model& model) const
+{
+
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
     const auto& filesystem = core::FilesystemLocator::get();
     const auto exists = filesystem.FileExists(Path(modelPath));
     if (!exists)
     {
         LogError(fmt::format("Could not find: {}", modelPath));
-        return INVALID_MODEL_INDEX;
+        return false;
+    }
+    if (std::string_view(modelPath).ends_with(MODEL_FILE_EXTENSION))
+    {
+        // big files can be memory mapped by the filesystem, and a pack keeps its stored files in place
+        const auto modelFile = filesystem.LoadFile(modelPath);
+        if (!model.Deserialize({ modelFile.data, modelFile.size }))
+        {
+            LogError(fmt::format("Could not read binary model file: {}", modelPath));
+            return false;
+        }
+        return true;
+    }
+    // the material libraries of an obj file are folded in the import settings of the key
+    AssetCacheKey cacheKey{};
+    if (assetCache_ != nullptr && assetCache_->IsOpen())
+    {
+        const auto modelFile = filesystem.LoadFile(modelPath);
+        const auto materialLibrariesHash = HashMaterialLibraries(filesystem, modelPath,
+            { reinterpret_cast<const char*>(modelFile.data), modelFile.size });
+        cacheKey = MakeAssetCacheKey({ modelFile.data, modelFile.size },
+            fmt::format("assimp:{}:{}:{}", MODEL_IMPORT_FLAGS, MODEL_CACHE_VERSION, materialLibrariesHash));
+        if (const auto cachedModel = assetCache_->Load(cacheKey); cachedModel.data != nullptr)
+        {
+            if (model.Deserialize({ cachedModel.data, cachedModel.size }))
+            {
+                return true;
+            }
+            model = {};
+            LogWarning(fmt::format("Could not read cached model: {}", modelPath));
+        }
     }
-    const auto* scene = importer_.ReadFile(modelPath.c_str(),
-        aiProcess_CalcTangentSpace | aiProcess_Triangulate | aiProcess_GenNormals | aiProcess_FlipUVs);
+    // an importer per load, so several models can be imported at the same time
+    Assimp::Importer importer;
+    importer.SetIOHandler(new IOSystem());
+    const auto* scene = importer.ReadFile(modelPath.c_str(), MODEL_IMPORT_FLAGS);
     
     if(scene == nullptr)
     {
-        LogError(fmt::format("Could not import scene, with error: {}", importer_.GetErrorString()));
-        return INVALID_MODEL_INDEX;
+        LogError(fmt::format("Could not import scene, with error: {}", importer.GetErrorString()));
+        return false;
     }
-    const auto modelIndex = ImportScene(scene);
-    modelNamesMap_[modelPath.c_str()] = modelIndex;
-    return modelIndex;
-
+    model.LoadMaterials(scene);
+    model.LoadFromNode(scene, scene->mRootNode);
+    if (assetCache_ != nullptr && assetCache_->IsOpen())
+    {
+        const auto serializedModel = model.Serialize();
+        assetCache_->Store(cacheKey, { reinterpret_cast<const unsigned char*>(serializedModel.data()), serializedModel.size() });
+    }
+    return true;
 }
 
 void ModelManager::Clear()
 {
     models_.clear();
+    modelNamesMap_.clear();
 }
 
-ModelIndex ModelManager::ImportScene(const aiScene* scene)
+ModelIndex ModelManager::AddModel(Model&& model)
 {
-
-#ifdef TRACY_ENABLE
-    ZoneScoped;
-#endif
     const ModelIndex index = {models_.size()};
-    Model model;
-    model.LoadMaterials(scene);
-    model.LoadFromNode(scene, scene->mRootNode);
-    models_.push_back(model);
+    models_.push_back(std::move(model));
     return index;
 }
 } // namespace core
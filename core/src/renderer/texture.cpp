@@ -1,2 +1,35 @@
-
 #include "renderer/texture.h"
+
+#include <cstring>
+#include <string>
+
+namespace core
+{
+
+bool ReadDecodedImage(const FileBuffer& cacheEntry, DecodedImageHeader& header, const unsigned char*& pixels)
+{
+    if (cacheEntry.data == nullptr || cacheEntry.size < sizeof(DecodedImageHeader))
+    {
+        return false;
+    }
+    std::memcpy(&header, cacheEntry.data, sizeof(DecodedImageHeader));
+    const auto pixelsSize = static_cast<std::size_t>(header.width) * header.height * header.channels * header.bytesPerChannel;
+    if (header.width <= 0 || header.height <= 0 || cacheEntry.size - sizeof(DecodedImageHeader) != pixelsSize)
+    {
+        return false;
+    }
+    pixels = cacheEntry.data + sizeof(DecodedImageHeader);
+    return true;
+}
+
+void StoreDecodedImage(AssetCache& assetCache, const AssetCacheKey& key, const DecodedImageHeader& header,
+    const unsigned char* pixels)
+{
+    const auto pixelsSize = static_cast<std::size_t>(header.width) * header.height * header.channels * header.bytesPerChannel;
+    std::string cacheEntry(sizeof(DecodedImageHeader) + pixelsSize, '\0');
+    std::memcpy(cacheEntry.data(), &header, sizeof(DecodedImageHeader));
+    std::memcpy(cacheEntry.data() + sizeof(DecodedImageHeader), pixels, pixelsSize);
+    assetCache.Store(key, { reinterpret_cast<const unsigned char*>(cacheEntry.data()), cacheEntry.size() });
+}
+
+} // namespace core
@@ -0,0 +1,200 @@
+#include "renderer/vertex_layout.h"
+
+#include "utils/log.h"
+#include "utils/parallel.h"
+
+#include <fmt/format.h>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/packing.hpp>
+#include <glm/gtc/packing.hpp>
+#include <glm/vector_relational.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <limits>
+
+#ifdef TRACY_ENABLE
+#include <tracy/Tracy.hpp>
+#endif
+
+namespace core
+{
+
+namespace
+{
+constexpr std::size_t VERTEX_ENCODING_GRAIN = 4096;
+
+constexpr VertexLayoutInfo FULL_VERTEX_LAYOUT = {
+    sizeof(Vertex), 5,
+    {{
+        { VertexAttributeType::FLOAT, 3, offsetof(Vertex, position) },
+        { VertexAttributeType::FLOAT, 2, offsetof(Vertex, texCoords) },
+        { VertexAttributeType::FLOAT, 3, offsetof(Vertex, normal) },
+        { VertexAttributeType::FLOAT, 3, offsetof(Vertex, tangent) },
+        { VertexAttributeType::FLOAT, 3, offsetof(Vertex, bitangent) },
+    }}
+};
+constexpr VertexLayoutInfo COMPACT_VERTEX_LAYOUT = {
+    32, 4,
+    {{
+        { VertexAttributeType::FLOAT, 3, 0 },
+        { VertexAttributeType::HALF_FLOAT, 2, 12 },
+        { VertexAttributeType::SNORM16, 4, 16 },
+        { VertexAttributeType::SNORM16, 4, 24 },
+    }}
+};
+constexpr VertexLayoutInfo QUANTIZED_VERTEX_LAYOUT = {
+    20, 4,
+    {{
+        { VertexAttributeType::SNORM16, 4, 0 },
+        { VertexAttributeType::HALF_FLOAT, 2, 8 },
+        { VertexAttributeType::SNORM8, 4, 12 },
+        { VertexAttributeType::SNORM8, 4, 16 },
+    }}
+};
+
+template<typename T>
+void WriteAttribute(std::byte* destination, const VertexAttributeFormat& format, const T& value)
+{
+    std::memcpy(destination + format.offset, &value, sizeof(T));
+}
+
+/**
+ * @brief GetTangentFrame returns the tangent with the sign of the bitangent in w
+ */
+glm::vec4 GetTangentFrame(const Vertex& vertex)
+{
+    const auto sign = glm::dot(glm::cross(vertex.normal, vertex.tangent), vertex.bitangent) < 0.0f ? -1.0f : 1.0f;
+    return { vertex.tangent, sign };
+}
+
+PositionQuantization GetPositionQuantization(std::span<const Vertex> vertices)
+{
+    if (vertices.empty())
+    {
+        return {};
+    }
+    glm::vec3 boundsMin{ std::numeric_limits<float>::max() };
+    glm::vec3 boundsMax{ std::numeric_limits<float>::lowest() };
+    for (const auto& vertex : vertices)
+    {
+        boundsMin = glm::min(boundsMin, vertex.position);
+        boundsMax = glm::max(boundsMax, vertex.position);
+    }
+    PositionQuantization quantization;
+    quantization.offset = (boundsMin + boundsMax) * 0.5f;
+    // a flat mesh keeps a scale of one on its flat axis, so the positions stay finite
+    const auto halfExtents = (boundsMax - boundsMin) * 0.5f;
+    quantization.scale = glm::mix(glm::vec3(1.0f), halfExtents, glm::greaterThan(halfExtents, glm::vec3(0.0f)));
+    return quantization;
+}
+}
+
+const VertexLayoutInfo& GetVertexLayoutInfo(pb::VertexLayout vertexLayout)
+{
+    switch (vertexLayout)
+    {
+    case pb::COMPACT_VERTEX:
+        return COMPACT_VERTEX_LAYOUT;
+    case pb::QUANTIZED_VERTEX:
+        return QUANTIZED_VERTEX_LAYOUT;
+    default:
+        return FULL_VERTEX_LAYOUT;
+    }
+}
+
+bool CheckVertexLayouts(const pb::Scene& scene)
+{
+    bool matching = true;
+    for (const auto& pipeline : scene.pipelines())
+    {
+        const auto& layoutInfo = GetVertexLayoutInfo(pipeline.vertex_layout());
+        if (pipeline.type() == pb::Pipeline_Type_RASTERIZE && pipeline.in_vertex_attributes_size() > static_cast<int>(layoutInfo.attributeCount))
+        {
+            LogError(fmt::format("Pipeline {} reads {} vertex attributes, {} has {}, rebuild the bitangent from the tangent sign",
+                pipeline.name(), pipeline.in_vertex_attributes_size(), pb::VertexLayout_Name(pipeline.vertex_layout()), layoutInfo.attributeCount));
+            matching = false;
+        }
+    }
+    for (const auto& subPass : scene.render_pass().sub_passes())
+    {
+        for (const auto& command : subPass.commands())
+        {
+            const auto meshIndex = command.mesh_index();
+            const auto materialIndex = command.material_index();
+            if (meshIndex < 0 || meshIndex >= scene.meshes_size() || materialIndex < 0 || materialIndex >= scene.materials_size())
+            {
+                continue;
+            }
+            const auto& mesh = scene.meshes(meshIndex);
+            const auto pipelineIndex = scene.materials(materialIndex).pipeline_index();
+            if (mesh.primitve_type() == pb::Mesh_PrimitveType_NONE || pipelineIndex < 0 || pipelineIndex >= scene.pipelines_size())
+            {
+                continue;
+            }
+            const auto& pipeline = scene.pipelines(pipelineIndex);
+            if (mesh.vertex_layout() != pipeline.vertex_layout())
+            {
+                LogError(fmt::format("Draw command {} draws mesh {} in {} with pipeline {} in {}",
+                    command.name(), meshIndex, pb::VertexLayout_Name(mesh.vertex_layout()),
+                    pipeline.name(), pb::VertexLayout_Name(pipeline.vertex_layout())));
+                matching = false;
+            }
+        }
+    }
+    return matching;
+}
+
+PositionQuantization EncodeVertices(std::span<const Vertex> vertices, pb::VertexLayout vertexLayout, std::span<std::byte> out)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    const auto& layoutInfo = GetVertexLayoutInfo(vertexLayout);
+    switch (vertexLayout)
+    {
+    case pb::COMPACT_VERTEX:
+    {
+        ParallelForRange(0, vertices.size(), VERTEX_ENCODING_GRAIN, [&](std::size_t begin, std::size_t end)
+        {
+            const auto& attributes = layoutInfo.attributes;
+            for (std::size_t i = begin; i < end; i++)
+            {
+                const auto& vertex = vertices[i];
+                auto* destination = out.data() + i * layoutInfo.stride;
+                WriteAttribute(destination, attributes[0], vertex.position);
+                WriteAttribute(destination, attributes[1], glm::packHalf2x16(vertex.texCoords));
+                WriteAttribute(destination, attributes[2], glm::packSnorm4x16(glm::vec4(vertex.normal, 0.0f)));
+                WriteAttribute(destination, attributes[3], glm::packSnorm4x16(GetTangentFrame(vertex)));
+            }
+        });
+        return {};
+    }
+    case pb::QUANTIZED_VERTEX:
+    {
+        const auto quantization = GetPositionQuantization(vertices);
+        const auto inverseScale = 1.0f / quantization.scale;
+        ParallelForRange(0, vertices.size(), VERTEX_ENCODING_GRAIN, [&](std::size_t begin, std::size_t end)
+        {
+            const auto& attributes = layoutInfo.attributes;
+            for (std::size_t i = begin; i < end; i++)
+            {
+                const auto& vertex = vertices[i];
+                auto* destination = out.data() + i * layoutInfo.stride;
+                const auto position = (vertex.position - quantization.offset) * inverseScale;
+                WriteAttribute(destination, attributes[0], glm::packSnorm4x16(glm::vec4(position, 1.0f)));
+                WriteAttribute(destination, attributes[1], glm::packHalf2x16(vertex.texCoords));
+                WriteAttribute(destination, attributes[2], glm::packSnorm4x8(glm::vec4(vertex.normal, 0.0f)));
+                WriteAttribute(destination, attributes[3], glm::packSnorm4x8(GetTangentFrame(vertex)));
+            }
+        });
+        return quantization;
+    }
+    default:
+        std::memcpy(out.data(), vertices.data(), vertices.size_bytes());
+        return {};
+    }
+}
+
+} // namespace core
@@ -0,0 +1,182 @@
+#include "utils/coroutine_job.h"
+
+#include <thread>
+
+namespace core
+{
+
+JobTask::~JobTask()
+{
+    if (handle_)
+    {
+        handle_.destroy();
+    }
+}
+
+JobTask& JobTask::operator=(JobTask&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (handle_)
+        {
+            handle_.destroy();
+        }
+        handle_ = std::exchange(other.handle_, {});
+    }
+    return *this;
+}
+
+void CompletionToken::Signal()
+{
+    Lock();
+    isSignaled_.store(true, std::memory_order_release);
+    for (auto* job : waitingJobs_)
+    {
+        job->Release();
+    }
+    waitingJobs_.clear();
+    Unlock();
+}
+
+bool CompletionToken::IsSignaled() const
+{
+    return isSignaled_.load(std::memory_order_acquire);
+}
+
+void CompletionToken::Reset()
+{
+    Lock();
+    isSignaled_.store(false, std::memory_order_release);
+    waitingJobs_.clear();
+    Unlock();
+}
+
+void CompletionToken::Lock()
+{
+    while (lock_.test_and_set(std::memory_order_acquire))
+    {
+        std::this_thread::yield();
+    }
+}
+
+void CompletionToken::Unlock()
+{
+    lock_.clear(std::memory_order_release);
+}
+
+bool CompletionToken::Awaiter::await_suspend(JobTask::Handle handle)
+{
+    auto* job = handle.promise().job;
+    job->BeginWait();
+    token.Lock();
+    if (token.IsSignaled())
+    {
+        token.Unlock();
+        job->CancelWait();
+        return false;
+    }
+    token.waitingJobs_.push_back(job);
+    token.Unlock();
+    job->Suspend();
+    return true;
+}
+
+void CoroutineJob::ExecuteImpl()
+{
+    if (!task_.GetHandle())
+    {
+        task_ = coroutineFunc_();
+        task_.GetHandle().promise().job = this;
+    }
+    task_.GetHandle().resume();
+    if (IsCurrentExecutionSuspended())
+    {
+        // the coroutine can already be resumed on another thread
+        return;
+    }
+    task_ = {};
+}
+
+void CoroutineJob::BeginWait()
+{
+    pendingDependencies_.store(1, std::memory_order_release);
+}
+
+void CoroutineJob::CancelWait()
+{
+    pendingDependencies_.store(0, std::memory_order_release);
+}
+
+void CoroutineJob::Suspend()
+{
+    SuspendCurrentExecution();
+}
+
+void CoroutineJob::Release()
+{
+    if (pendingDependencies_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        jobSystem_->Schedule(this);
+    }
+}
+
+void CoroutineJob::SwitchQueue(int queueIndex)
+{
+    if (queueIndex_ == queueIndex)
+    {
+        return;
+    }
+    if (isPendingMainJob_)
+    {
+        jobSystem_->ReleasePendingMainJob(this);
+    }
+    queueIndex_ = queueIndex;
+    if (queueIndex == MAIN_QUEUE_INDEX)
+    {
+        jobSystem_->AddPendingMainJob(this);
+    }
+}
+
+void CoroutineJob::Reschedule()
+{
+    jobSystem_->Schedule(this);
+}
+
+bool CoroutineJob::AddToSuccessors(Job& job)
+{
+    return job.AddSuccessor(this);
+}
+
+bool CoroutineJob::JobAwaiter::await_suspend(JobTask::Handle handle)
+{
+    auto* coroutineJob = handle.promise().job;
+    coroutineJob->BeginWait();
+    if (!coroutineJob->AddToSuccessors(job))
+    {
+        // the job was done in the meantime
+        coroutineJob->CancelWait();
+        return false;
+    }
+    coroutineJob->Suspend();
+    return true;
+}
+
+void CoroutineJob::QueueAwaiter::await_suspend(JobTask::Handle handle)
+{
+    auto* coroutineJob = handle.promise().job;
+    coroutineJob->SwitchQueue(queueIndex);
+    coroutineJob->Suspend();
+    coroutineJob->Reschedule();
+}
+
+CoroutineJob::JobAwaiter WaitForJob(Job& job)
+{
+    return { job };
+}
+
+CoroutineJob::QueueAwaiter SwitchToQueue(int queueIndex)
+{
+    return { queueIndex };
+}
+
+} // namespace core
@@ -0,0 +1,108 @@
+#include "utils/job_graph.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cassert>
+
+#ifdef TRACY_ENABLE
+#include <tracy/Tracy.hpp>
+#endif
+
+namespace core
+{
+
+void JobGraph::AddJob(Job* job, int queueIndex)
+{
+    nodes_.push_back({ job, queueIndex });
+    isCompiled_ = false;
+}
+
+bool JobGraph::AddDependency(Job* job, Job* dependency)
+{
+    isCompiled_ = false;
+    return job->AddDependency(dependency);
+}
+
+bool JobGraph::Compile()
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    // Kahn's algorithm on the dependencies that are part of the graph
+    const auto nodeCount = nodes_.size();
+    std::vector<int> inDegrees(nodeCount, 0);
+    std::vector<std::vector<std::size_t>> successors(nodeCount);
+    for (std::size_t i = 0; i < nodeCount; i++)
+    {
+        for (const auto& dependency : nodes_[i].job->dependencies_)
+        {
+            const auto it = std::ranges::find_if(nodes_, [&dependency](const Node& node)
+            {
+                return node.job == dependency.job;
+            });
+            if (it == nodes_.end())
+            {
+                continue;
+            }
+            successors[std::distance(nodes_.begin(), it)].push_back(i);
+            inDegrees[i]++;
+        }
+    }
+    std::vector<Node> sortedNodes;
+    sortedNodes.reserve(nodeCount);
+    std::vector<std::size_t> readyNodes;
+    for (std::size_t i = 0; i < nodeCount; i++)
+    {
+        if (inDegrees[i] == 0)
+        {
+            readyNodes.push_back(i);
+        }
+    }
+    // keeping the insertion order between independent jobs
+    std::size_t readyIndex = 0;
+    while (readyIndex < readyNodes.size())
+    {
+        const auto nodeIndex = readyNodes[readyIndex++];
+        sortedNodes.push_back(nodes_[nodeIndex]);
+        for (const auto successor : successors[nodeIndex])
+        {
+            if (--inDegrees[successor] == 0)
+            {
+                readyNodes.push_back(successor);
+            }
+        }
+    }
+    if (sortedNodes.size() != nodeCount)
+    {
+        LogError("Could not compile job graph, it contains a cycle");
+        isCompiled_ = false;
+        return false;
+    }
+    nodes_ = std::move(sortedNodes);
+    isCompiled_ = true;
+    return true;
+}
+
+void JobGraph::Run(JobSystem& jobSystem)
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+#endif
+    assert(isCompiled_);
+    for (const auto& node : nodes_)
+    {
+        node.job->Reset();
+    }
+    for (const auto& node : nodes_)
+    {
+        jobSystem.Submit(node.job, node.queueIndex);
+    }
+}
+
+void JobGraph::Clear()
+{
+    nodes_.clear();
+    isCompiled_ = false;
+}
+
+} // namespace core
@@ -0,0 +1,72 @@
+#include "utils/job_pool.h"
+
+namespace core
+{
+
+static constexpr std::uint64_t PackFreeHead(std::uint32_t index, std::uint32_t tag)
+{
+    return (static_cast<std::uint64_t>(tag) << 32u) | index;
+}
+
+JobPoolBase::JobPoolBase(std::size_t blockSize, std::size_t blockAlignment, std::uint32_t capacity) :
+    nextFree_(std::make_unique<std::atomic<std::uint32_t>[]>(capacity)),
+    blockSize_((blockSize + blockAlignment - 1) / blockAlignment * blockAlignment),
+    blockAlignment_(blockAlignment),
+    capacity_(capacity)
+{
+    blocks_ = static_cast<std::byte*>(::operator new(blockSize_ * capacity_, std::align_val_t(blockAlignment_)));
+    for (std::uint32_t i = 0; i < capacity_; i++)
+    {
+        nextFree_[i].store(i + 1 < capacity_ ? i + 1 : INVALID_INDEX, std::memory_order_relaxed);
+    }
+    freeHead_.store(PackFreeHead(capacity_ > 0 ? 0 : INVALID_INDEX, 0), std::memory_order_release);
+}
+
+JobPoolBase::~JobPoolBase()
+{
+    ::operator delete(blocks_, std::align_val_t(blockAlignment_));
+}
+
+void* JobPoolBase::AllocateBlock()
+{
+    auto head = freeHead_.load(std::memory_order_acquire);
+    while (true)
+    {
+        const auto index = static_cast<std::uint32_t>(head);
+        if (index == INVALID_INDEX)
+        {
+            CountJobAllocation(JobAllocationType::POOL_OVERFLOW);
+            return nullptr;
+        }
+        const auto next = nextFree_[index].load(std::memory_order_relaxed);
+        const auto newHead = PackFreeHead(next, static_cast<std::uint32_t>(head >> 32u) + 1);
+        if (freeHead_.compare_exchange_weak(head, newHead, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            CountJobAllocation(JobAllocationType::POOL);
+            return blocks_ + static_cast<std::size_t>(index) * blockSize_;
+        }
+    }
+}
+
+void JobPoolBase::ReleaseBlock(void* block)
+{
+    const auto index = static_cast<std::uint32_t>((static_cast<std::byte*>(block) - blocks_) / blockSize_);
+    auto head = freeHead_.load(std::memory_order_acquire);
+    while (true)
+    {
+        nextFree_[index].store(static_cast<std::uint32_t>(head), std::memory_order_relaxed);
+        const auto newHead = PackFreeHead(index, static_cast<std::uint32_t>(head >> 32u) + 1);
+        if (freeHead_.compare_exchange_weak(head, newHead, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            return;
+        }
+    }
+}
+
+bool JobPoolBase::Owns(const void* ptr) const
+{
+    const auto* bytePtr = static_cast<const std::byte*>(ptr);
+    return bytePtr >= blocks_ && bytePtr < blocks_ + blockSize_ * capacity_;
+}
+
+} // namespace core
@@ -1,13 +1,122 @@
 #include "utils/job_system.h"
+#include "utils/job_pool.h"
+#include "utils/log.h"
+#include "utils/thread_utils.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+#ifdef TRACY_ENABLE
+#include <tracy/Tracy.hpp>
+#endif
 
 namespace core
 {
 
-void Job::Execute()
+static thread_local Worker* currentWorker = nullptr;
+static thread_local bool isCurrentJobSuspended = false;
+/**
+ * @brief executionDepth counts the nested job executions on this thread, only the outermost one counts as busy time
+ */
+static thread_local int executionDepth = 0;
+static std::atomic<std::uint64_t> successorLockContentions{ 0 };
+static std::array<std::atomic<std::uint64_t>, static_cast<std::size_t>(JobAllocationType::LENGTH)> jobAllocationCounts{};
+
+void CountJobAllocation(JobAllocationType type)
+{
+    jobAllocationCounts[static_cast<std::size_t>(type)].fetch_add(1, std::memory_order_relaxed);
+}
+
+JobAllocationCounters GetJobAllocationCounters()
+{
+    JobAllocationCounters counters;
+    counters.heapAllocations = jobAllocationCounts[static_cast<std::size_t>(JobAllocationType::HEAP)].load(std::memory_order_relaxed);
+    counters.poolAllocations = jobAllocationCounts[static_cast<std::size_t>(JobAllocationType::POOL)].load(std::memory_order_relaxed);
+    counters.poolOverflows = jobAllocationCounts[static_cast<std::size_t>(JobAllocationType::POOL_OVERFLOW)].load(std::memory_order_relaxed);
+    return counters;
+}
+
+void* Job::operator new(std::size_t size)
+{
+    CountJobAllocation(JobAllocationType::HEAP);
+    return ::operator new(size);
+}
+
+void Job::operator delete(void* ptr) noexcept
+{
+    ::operator delete(ptr);
+}
+
+std::shared_ptr<Job> JobDependency::Lock() const
+{
+    if (isOwned)
+    {
+        return owner.lock();
+    }
+    // not owning, the dependency outlives its dependents
+    return { std::shared_ptr<Job>(), job };
+}
+
+Job::~Job()
 {
+    LockSuccessors();
+    ReleaseSuccessors(startSuccessors_);
+    ReleaseSuccessors(successors_);
+    UnlockSuccessors();
+}
+
+bool Job::Execute()
+{
+    LockSuccessors();
     hasStarted_.store(true, std::memory_order_release);
+    startSuccessorsClosed_ = true;
+    ReleaseSuccessors(startSuccessors_);
+    UnlockSuccessors();
+    const bool wasSuspended = std::exchange(isCurrentJobSuspended, false);
     ExecuteImpl();
-    isDone_.store(true, std::memory_order_release);
+    if (std::exchange(isCurrentJobSuspended, wasSuspended))
+    {
+        // the job may already be executed again on another thread
+        return false;
+    }
+    // the job can be added again as soon as it is done, so the reference is released when leaving
+    const auto keepAlive = std::move(keepAlive_);
+    if (isPendingMainJob_)
+    {
+        jobSystem_->ReleasePendingMainJob(this);
+    }
+    auto* pool = pool_;
+    // the successors list is closed when the job is done, later successors will see it as done
+    LockSuccessors();
+    successorsClosed_ = true;
+    if (pool == nullptr)
+    {
+        // published before the successors are released, so a JobGraph replay cannot reset the job before it,
+        // an owner destroying the job now waits in ~Job for the successors lock
+        isDone_.store(true, std::memory_order_release);
+    }
+    ReleaseSuccessors(successors_);
+    // last access to the job when it is not pooled
+    UnlockSuccessors();
+    if (pool != nullptr)
+    {
+        // pooled jobs are recycled as soon as they are done
+        pool->Release(this);
+    }
+    return true;
+}
+
+void Job::SuspendCurrentExecution()
+{
+    isCurrentJobSuspended = true;
+}
+
+bool Job::IsCurrentExecutionSuspended()
+{
+    return isCurrentJobSuspended;
 }
 
 bool Job::HasStarted() const
@@ -22,13 +131,143 @@ bool Job::IsDone() const
 
 bool Job::ShouldStart() const
 {
-    return true;
+    return pendingDependencies_.load(std::memory_order_acquire) == 0;
 }
 
 void Job::Reset()
 {
-    hasStarted_.store(false, std::memory_order_release);
+    // the successors registered before the reset wait for the next run
+    LockSuccessors();
     isDone_.store(false, std::memory_order_release);
+    hasStarted_.store(false, std::memory_order_release);
+    successorsClosed_ = false;
+    startSuccessorsClosed_ = false;
+    UnlockSuccessors();
+    pendingDependencies_.store(static_cast<int>(dependencies_.size()) + 1, std::memory_order_release);
+}
+
+bool Job::AddDependency(Job* dependency, JobDependencyType type)
+{
+    return AddDependency(JobDependency{ .job = dependency, .type = type });
+}
+
+bool Job::AddDependency(const std::weak_ptr<Job>& dependency, JobDependencyType type)
+{
+    // the weak_ptr is kept, the dependency may be destroyed before this job is added
+    const auto lockedDependency = dependency.lock();
+    return AddDependency(JobDependency{ .job = lockedDependency.get(), .owner = dependency, .type = type, .isOwned = true });
+}
+
+bool Job::AddDependency(JobDependency dependency)
+{
+    if (dependency.job == nullptr)
+    {
+        return false;
+    }
+    if (dependency.job == this || dependency.job->DependsOn(this))
+    {
+        LogError("Cannot add a cyclic job dependency");
+        return false;
+    }
+    dependencies_.push_back(std::move(dependency));
+    pendingDependencies_.fetch_add(1, std::memory_order_acq_rel);
+    return true;
+}
+
+bool Job::DependsOn(const Job* job) const
+{
+    // the visited dependencies are held, so the owned ones cannot expire during the walk
+    std::vector<std::shared_ptr<Job>> visited;
+    std::vector<const JobDependency*> stack;
+    for (const auto& dependency : dependencies_)
+    {
+        stack.push_back(&dependency);
+    }
+    while (!stack.empty())
+    {
+        const auto* dependency = stack.back();
+        stack.pop_back();
+        // an expired dependency is done, it cannot close a cycle
+        auto lockedDependency = dependency->Lock();
+        if (lockedDependency == nullptr)
+        {
+            continue;
+        }
+        if (lockedDependency.get() == job)
+        {
+            return true;
+        }
+        if (std::ranges::find(visited, lockedDependency) != visited.end())
+        {
+            continue;
+        }
+        for (const auto& nextDependency : lockedDependency->dependencies_)
+        {
+            stack.push_back(&nextDependency);
+        }
+        visited.push_back(std::move(lockedDependency));
+    }
+    return false;
+}
+
+bool Job::AddSuccessor(Job* successor, JobDependencyType type)
+{
+    LockSuccessors();
+    const bool isStart = type == JobDependencyType::START;
+    if (isStart ? startSuccessorsClosed_ : successorsClosed_)
+    {
+        UnlockSuccessors();
+        return false;
+    }
+    (isStart ? startSuccessors_ : successors_).push_back(successor);
+    UnlockSuccessors();
+    return true;
+}
+
+void Job::DetachFromDependencies()
+{
+    for (const auto& dependency : dependencies_)
+    {
+        const auto lockedDependency = dependency.Lock();
+        if (lockedDependency == nullptr)
+        {
+            continue;
+        }
+        lockedDependency->LockSuccessors();
+        std::erase(lockedDependency->startSuccessors_, this);
+        std::erase(lockedDependency->successors_, this);
+        lockedDependency->UnlockSuccessors();
+    }
+}
+
+void Job::ReleaseSuccessors(std::vector<Job*>& successors)
+{
+    for (auto* successor : successors)
+    {
+        if (successor->pendingDependencies_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            successor->jobSystem_->Schedule(successor);
+        }
+    }
+    successors.clear();
+}
+
+void Job::LockSuccessors()
+{
+    if (!successorsLock_.test_and_set(std::memory_order_acquire))
+    {
+        return;
+    }
+    successorLockContentions.fetch_add(1, std::memory_order_relaxed);
+    while (successorsLock_.test_and_set(std::memory_order_acquire))
+    {
+        std::this_thread::yield();
+    }
+}
+
+void Job::UnlockSuccessors()
+{
+    successorsLock_.clear(std::memory_order_release);
 }
 
 void FuncJob::ExecuteImpl()
@@ -36,83 +275,389 @@ void FuncJob::ExecuteImpl()
     func_();
 }
 
-bool FuncDependentJob::ShouldStart() const
+DependenciesJob::DependenciesJob(std::initializer_list<std::weak_ptr<Job>> dependencies)
 {
-    const auto dependencyJob = dependency_.lock();
-    if(dependencyJob != nullptr)
+    for (const auto& dependency : dependencies)
     {
-        return dependencyJob->HasStarted();
+        AddDependency(dependency);
     }
-    return false;
 }
 
-bool DependenciesJob::ShouldStart() const
+FuncDependentJob::FuncDependentJob(const std::weak_ptr<Job>& dependency, const std::function<void(void)>& func) :
+    FuncJob(func)
+{
+    AddDependency(dependency);
+}
+
+FuncDependenciesJob::FuncDependenciesJob(std::initializer_list<std::weak_ptr<Job>> dependencies,
+    const std::function<void(void)>& func) :
+    FuncJob(func)
+{
+    for (const auto& dependency : dependencies)
+    {
+        AddDependency(dependency);
+    }
+}
+
+bool WorkStealingDeque::Push(Job* job)
+{
+    const auto bottom = bottom_.load(std::memory_order_relaxed);
+    const auto top = top_.load(std::memory_order_acquire);
+    if (bottom - top >= CAPACITY)
+    {
+        return false;
+    }
+    buffer_[bottom & (CAPACITY - 1)].store(job, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+    return true;
+}
+
+Job* WorkStealingDeque::Pop()
 {
-    bool shouldStart = true;
-    for (auto& dependency : dependencies_)
+    const auto bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto top = top_.load(std::memory_order_relaxed);
+    if (top > bottom)
     {
-        const auto dependencyJob = dependency.lock();
-        if (dependencyJob != nullptr && !dependencyJob->HasStarted())
+        // deque was already empty
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    Job* job = buffer_[bottom & (CAPACITY - 1)].load(std::memory_order_relaxed);
+    if (top == bottom)
+    {
+        // last element, race against the thieves
+        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
         {
-            shouldStart = false;
-            break;
+            job = nullptr;
         }
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
     }
-    return shouldStart;
+    return job;
 }
 
-void DependenciesJob::AddDependency(const std::weak_ptr<Job>& dependency)
+Job* WorkStealingDeque::Steal()
 {
-    //TODO check if dependency is not cyclic
-    dependencies_.push_back(dependency);
+    auto top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const auto bottom = bottom_.load(std::memory_order_acquire);
+    if (top >= bottom)
+    {
+        return nullptr;
+    }
+    Job* job = buffer_[top & (CAPACITY - 1)].load(std::memory_order_relaxed);
+    if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+    {
+        // lost the race against another thief or the owner
+        return nullptr;
+    }
+    return job;
 }
 
-void WorkerQueue::Begin()
+bool WorkStealingDeque::IsEmpty() const
 {
-    isRunning_.store(true, std::memory_order_release);
+    return top_.load(std::memory_order_acquire) >= bottom_.load(std::memory_order_acquire);
 }
 
-void WorkerQueue::AddJob(const std::shared_ptr<Job>& newJob)
+JobRing::JobRing() : buffer_(std::make_unique<Cell[]>(CAPACITY))
 {
-    std::scoped_lock lock(mutex_);
-    jobsQueue_.push(newJob);
-    conditionVariable_.notify_one();
+    for (std::size_t i = 0; i < CAPACITY; i++)
+    {
+        buffer_[i].sequence.store(i, std::memory_order_relaxed);
+    }
 }
 
-bool WorkerQueue::IsEmpty() const
+void JobRing::Push(Job* newJob)
+{
+    if (TryPush(newJob))
+    {
+        return;
+    }
+    std::scoped_lock lock(overflowMutex_);
+    overflow_.push_back(newJob);
+    overflowPushes_.fetch_add(1, std::memory_order_relaxed);
+    hasOverflow_.store(true, std::memory_order_release);
+}
+
+std::size_t JobRing::GetSize() const
 {
-    std::shared_lock lock(mutex_);
-    return jobsQueue_.empty();
+    const auto dequeuePos = dequeuePos_.load(std::memory_order_relaxed);
+    const auto enqueuePos = enqueuePos_.load(std::memory_order_relaxed);
+    const auto ringSize = enqueuePos > dequeuePos ? enqueuePos - dequeuePos : 0;
+    if (!hasOverflow_.load(std::memory_order_relaxed))
+    {
+        return ringSize;
+    }
+    std::scoped_lock lock(overflowMutex_);
+    return ringSize + overflow_.size();
 }
 
-bool WorkerQueue::IsRunning() const
+std::uint64_t JobRing::GetPushCount() const
 {
-    return isRunning_.load(std::memory_order_acquire);
+    return enqueuePos_.load(std::memory_order_relaxed) + overflowPushes_.load(std::memory_order_relaxed);
 }
 
-std::shared_ptr<Job> WorkerQueue::PopNextTask()
+bool JobRing::IsEmpty() const
 {
-    if (IsEmpty())
+    return enqueuePos_.load(std::memory_order_acquire) == dequeuePos_.load(std::memory_order_acquire) &&
+        !hasOverflow_.load(std::memory_order_acquire);
+}
+
+Job* JobRing::Pop()
+{
+    if (auto* job = TryPop(); job != nullptr)
+    {
+        return job;
+    }
+    if (!hasOverflow_.load(std::memory_order_acquire))
+    {
         return nullptr;
+    }
+    std::scoped_lock lock(overflowMutex_);
+    if (overflow_.empty())
+    {
+        return nullptr;
+    }
+    auto* job = overflow_.front();
+    overflow_.pop_front();
+    hasOverflow_.store(!overflow_.empty(), std::memory_order_release);
+    return job;
+}
 
-    std::scoped_lock lock(mutex_);
-    if (jobsQueue_.empty())
+bool JobRing::TryPush(Job* newJob)
+{
+    auto pos = enqueuePos_.load(std::memory_order_relaxed);
+    while (true)
+    {
+        auto& cell = buffer_[pos & (CAPACITY - 1)];
+        const auto sequence = cell.sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+        if (diff == 0)
+        {
+            if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                cell.job = newJob;
+                cell.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0)
+        {
+            // ring is full
+            return false;
+        }
+        else
+        {
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+Job* JobRing::TryPop()
+{
+    auto pos = dequeuePos_.load(std::memory_order_relaxed);
+    while (true)
+    {
+        auto& cell = buffer_[pos & (CAPACITY - 1)];
+        const auto sequence = cell.sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos + 1);
+        if (diff == 0)
+        {
+            if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                auto* job = cell.job;
+                cell.sequence.store(pos + CAPACITY, std::memory_order_release);
+                return job;
+            }
+        }
+        else if (diff < 0)
+        {
+            // ring is empty
+            return nullptr;
+        }
+        else
+        {
+            pos = dequeuePos_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void WorkerQueue::AddJob(Job* newJob)
+{
+    rings_[static_cast<std::size_t>(newJob->GetPriority())].Push(newJob);
+}
+
+bool WorkerQueue::IsEmpty() const
+{
+    return std::ranges::all_of(rings_, [](const auto& ring) { return ring.IsEmpty(); });
+}
+
+Job* WorkerQueue::PopNextTask(JobPriority lowestPriority)
+{
+    const auto levelCount = static_cast<std::uint32_t>(lowestPriority) + 1;
+    // critical jobs are never delayed by aging
+    constexpr auto criticalLevel = static_cast<std::uint32_t>(JobPriority::CRITICAL);
+    if (auto* job = rings_[criticalLevel].Pop(); job != nullptr)
+    {
+        return job;
+    }
+    // aging, each pop while aged jobs wait takes a ticket, so the concurrent pops cannot skip the aged turn of a period
+    constexpr auto firstAgedLevel = static_cast<std::uint32_t>(JobPriority::NORMAL);
+    const auto hasAgedJobs = levelCount > firstAgedLevel && std::any_of(rings_.begin() + firstAgedLevel,
+        rings_.begin() + levelCount, [](const auto& ring) { return !ring.IsEmpty(); });
+    if (hasAgedJobs && popCount_.fetch_add(1, std::memory_order_relaxed) % AGING_PERIOD == AGING_PERIOD - 1)
+    {
+        if (auto* job = PopAgedTask(lowestPriority); job != nullptr)
+        {
+            return job;
+        }
+    }
+    for (std::uint32_t level = criticalLevel + 1; level < levelCount; level++)
+    {
+        if (auto* job = rings_[level].Pop(); job != nullptr)
+        {
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+Job* WorkerQueue::PopAgedTask(JobPriority lowestPriority)
+{
+    constexpr auto firstAgedLevel = static_cast<std::uint32_t>(JobPriority::NORMAL);
+    const auto levelCount = static_cast<std::uint32_t>(lowestPriority) + 1;
+    if (levelCount <= firstAgedLevel)
+    {
         return nullptr;
-    auto newTask = jobsQueue_.front();
-    jobsQueue_.pop();
-    return newTask;
+    }
+    // the aged priorities are served in turn, the next ones are tried when the one of the turn is empty
+    const auto agedLevelCount = levelCount - firstAgedLevel;
+    const auto agedTurn = agedTurn_.fetch_add(1, std::memory_order_relaxed);
+    for (std::uint32_t i = 0; i < agedLevelCount; i++)
+    {
+        if (auto* job = rings_[firstAgedLevel + (agedTurn + i) % agedLevelCount].Pop(); job != nullptr)
+        {
+            return job;
+        }
+    }
+    return nullptr;
 }
 
-void WorkerQueue::WaitForTask()
+QueueStats WorkerQueue::GetStats() const
 {
-    std::unique_lock lock(mutex_);
-    conditionVariable_.wait(lock);
+    QueueStats stats;
+    for (std::size_t i = 0; i < rings_.size(); i++)
+    {
+        stats.depth[i] = rings_[i].GetSize();
+        stats.jobsEnqueued += rings_[i].GetPushCount();
+        stats.overflowPushes += rings_[i].GetOverflowPushCount();
+    }
+    stats.jobsEnqueued -= pushBaseline_.load(std::memory_order_relaxed);
+    stats.overflowPushes -= overflowPushBaseline_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void WorkerQueue::ResetStats()
+{
+    std::uint64_t pushCount = 0;
+    std::uint64_t overflowPushCount = 0;
+    for (const auto& ring : rings_)
+    {
+        pushCount += ring.GetPushCount();
+        overflowPushCount += ring.GetOverflowPushCount();
+    }
+    pushBaseline_.store(pushCount, std::memory_order_relaxed);
+    overflowPushBaseline_.store(overflowPushCount, std::memory_order_relaxed);
+}
+
+void JobCounters::AddJob(std::chrono::nanoseconds latency, std::chrono::nanoseconds duration)
+{
+    const auto latencyNs = static_cast<std::uint64_t>(std::max<std::int64_t>(latency.count(), 0));
+    jobsExecuted_.fetch_add(1, std::memory_order_relaxed);
+    latencyNs_.fetch_add(latencyNs, std::memory_order_relaxed);
+    const auto bucket = std::min<std::size_t>(std::bit_width(latencyNs), LATENCY_BUCKET_COUNT - 1);
+    latencyHistogram_[bucket].fetch_add(1, std::memory_order_relaxed);
+    AddBusy(duration);
+}
+
+void JobCounters::AddBusy(std::chrono::nanoseconds duration)
+{
+    busyNs_.fetch_add(static_cast<std::uint64_t>(duration.count()), std::memory_order_relaxed);
+}
+
+void JobCounters::AddIdle(std::chrono::nanoseconds duration)
+{
+    idleNs_.fetch_add(static_cast<std::uint64_t>(duration.count()), std::memory_order_relaxed);
+}
+
+void JobCounters::AddSteal()
+{
+    steals_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void JobCounters::Reset()
+{
+    jobsExecuted_.store(0, std::memory_order_relaxed);
+    steals_.store(0, std::memory_order_relaxed);
+    busyNs_.store(0, std::memory_order_relaxed);
+    idleNs_.store(0, std::memory_order_relaxed);
+    latencyNs_.store(0, std::memory_order_relaxed);
+    for (auto& bucket : latencyHistogram_)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+void JobCounters::FillStats(WorkerStats& stats) const
+{
+    stats.jobsExecuted = jobsExecuted_.load(std::memory_order_relaxed);
+    stats.steals = steals_.load(std::memory_order_relaxed);
+    const auto busyNs = GetBusyTime();
+    const auto totalNs = busyNs + GetIdleTime();
+    stats.busyRatio = totalNs == 0 ? 0.0f : static_cast<float>(static_cast<double>(busyNs) / static_cast<double>(totalNs));
+    if (stats.jobsExecuted == 0)
+    {
+        return;
+    }
+    stats.averageLatencyUs = static_cast<float>(static_cast<double>(latencyNs_.load(std::memory_order_relaxed)) /
+        static_cast<double>(stats.jobsExecuted) / 1000.0);
+    std::array<std::uint64_t, LATENCY_BUCKET_COUNT> histogram{};
+    std::uint64_t histogramTotal = 0;
+    for (std::size_t i = 0; i < LATENCY_BUCKET_COUNT; i++)
+    {
+        histogram[i] = latencyHistogram_[i].load(std::memory_order_relaxed);
+        histogramTotal += histogram[i];
+    }
+    // the percentile is the upper bound of the bucket containing it
+    auto percentile = [&histogram, histogramTotal](double ratio)
+    {
+        const auto rank = static_cast<std::uint64_t>(ratio * static_cast<double>(histogramTotal));
+        std::uint64_t count = 0;
+        for (std::size_t i = 0; i < LATENCY_BUCKET_COUNT; i++)
+        {
+            count += histogram[i];
+            if (count > rank)
+            {
+                return static_cast<float>(static_cast<double>(std::uint64_t{ 1 } << i) / 1000.0);
+            }
+        }
+        return static_cast<float>(static_cast<double>(std::uint64_t{ 1 } << (LATENCY_BUCKET_COUNT - 1)) / 1000.0);
+    };
+    stats.p50LatencyUs = percentile(0.5);
+    stats.p95LatencyUs = percentile(0.95);
+    stats.p99LatencyUs = percentile(0.99);
 }
 
-void WorkerQueue::End()
+Worker::Worker(JobSystem& jobSystem, int queueIndex, int workerIndex, std::string_view name, std::vector<int> cores) :
+    jobSystem_(jobSystem),
+    name_(name),
+    cores_(std::move(cores)),
+    queueIndex_(queueIndex),
+    workerIndex_(workerIndex),
+    randomState_(0x9E3779B9u * static_cast<std::uint32_t>(workerIndex + 1))
 {
-    isRunning_.store(false, std::memory_order::release);
-    conditionVariable_.notify_all();
 }
 
 void Worker::Begin()
@@ -128,36 +673,106 @@ void Worker::End()
     }
 }
 
-void Worker::Run()
+std::uint32_t Worker::NextRandom()
+{
+    // xorshift32
+    randomState_ ^= randomState_ << 13;
+    randomState_ ^= randomState_ >> 17;
+    randomState_ ^= randomState_ << 5;
+    return randomState_;
+}
+
+Job* Worker::FindJob()
 {
-    while(queue_.IsRunning())
+    auto& queue = *jobSystem_.queues_[queueIndex_];
+    // every AGING_PERIOD pops of the worker, from its queue or its local deque, the less urgent priorities
+    // are served first, a flow of frame jobs or a worker feeding its own deque would starve them otherwise
+    if (popCount_ >= WorkerQueue::AGING_PERIOD)
     {
-        if (queue_.IsEmpty())
+        popCount_ = 0;
+        if (auto* job = queue.PopAgedTask(); job != nullptr)
         {
-            if (!queue_.IsRunning())
-            {
-                break;
-            }
-            queue_.WaitForTask();
+            return job;
         }
-        else
+    }
+    // the local deque only holds normal priority jobs
+    auto* job = queue.PopNextTask(JobPriority::FRAME);
+    if (job == nullptr)
+    {
+        job = deque_.Pop();
+    }
+    if (job == nullptr)
+    {
+        job = queue.PopNextTask();
+    }
+    if (job != nullptr)
+    {
+        popCount_++;
+        return job;
+    }
+    const auto workerCount = jobSystem_.GetWorkerCount();
+    if (workerCount > 1)
+    {
+        const auto start = NextRandom() % workerCount;
+        for (int i = 0; i < workerCount; i++)
         {
-            while (!queue_.IsEmpty())
+            const auto victimIndex = (start + i) % workerCount;
+            if (victimIndex == static_cast<std::uint32_t>(workerIndex_))
             {
-                auto newTask = queue_.PopNextTask();
-                if (newTask == nullptr)
-                    continue;
-                if (!newTask->ShouldStart())
-                {
-                    queue_.AddJob(std::move(newTask));
-                }
-                else
-                {
-                    newTask->Execute();
-                }
+                continue;
+            }
+            if (auto* job = jobSystem_.workers_[victimIndex]->deque_.Steal(); job != nullptr)
+            {
+                counters_.AddSteal();
+                return job;
             }
         }
     }
+    const auto queueCount = jobSystem_.GetQueueCount();
+    for (int i = 0; i < queueCount; i++)
+    {
+        if (i == queueIndex_)
+        {
+            continue;
+        }
+        // background jobs stay on their queue, they can block on I/O
+        if (auto* job = jobSystem_.queues_[i]->PopNextTask(JobPriority::NORMAL); job != nullptr)
+        {
+            counters_.AddSteal();
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+void Worker::Run()
+{
+    SetCurrentThreadName(name_);
+    if (!cores_.empty() && !SetCurrentThreadAffinity(cores_))
+    {
+        LogWarning(fmt::format("Could not set the affinity of worker {}", name_));
+    }
+    currentWorker = this;
+    auto& wakeup = jobSystem_.queueWakeups_[queueIndex_];
+    while(jobSystem_.IsRunning())
+    {
+        const auto epoch = wakeup.workEpoch.load(std::memory_order_acquire);
+        auto* newTask = FindJob();
+        if (newTask != nullptr)
+        {
+            jobSystem_.ExecuteJob(newTask);
+            continue;
+        }
+        wakeup.sleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+        if (jobSystem_.IsRunning())
+        {
+            const auto idleStart = std::chrono::steady_clock::now();
+            wakeup.workEpoch.wait(epoch, std::memory_order_seq_cst);
+            counters_.AddIdle(std::chrono::steady_clock::now() - idleStart);
+        }
+        wakeup.sleepingWorkers.fetch_sub(1, std::memory_order_relaxed);
+    }
+    currentWorker = nullptr;
 }
 
 static JobSystem* instance = nullptr;
@@ -167,70 +782,525 @@ JobSystem::JobSystem()
     instance = this;
 }
 
-int JobSystem::SetupNewQueue(int threadCount)
+JobSystem::~JobSystem()
 {
-    const int newQueueIndex = queues_.size();
-    queues_.emplace_back();
-    for(int i = 0; i < threadCount; i++)
+    End();
+}
+
+int JobSystem::SetupNewQueue(int threadCount, const WorkerPlacement& placement, std::string_view name)
+{
+    const int newQueueIndex = GetQueueCount();
+    if (newQueueIndex >= MAX_QUEUES)
+    {
+        LogError(fmt::format("JobSystem cannot have more than {} queues, queue {} is not created", MAX_QUEUES, name));
+        return INVALID_QUEUE_INDEX;
+    }
+    // a queue without workers would never execute its background jobs
+    if (threadCount <= 0 || GetWorkerCount() >= MAX_WORKERS)
     {
-        workers_.emplace_back(queues_.back());
+        LogError(fmt::format("JobSystem queue {} would have no worker, {} requested and {} of {} workers used",
+            name, threadCount, GetWorkerCount(), MAX_WORKERS));
+        return INVALID_QUEUE_INDEX;
+    }
+    if (placement.policy == WorkerPlacement::Policy::NUMA_NODE)
+    {
+        const auto nodeCores = GetNumaNodeCores(placement.numaNode);
+        if (!nodeCores.empty())
+        {
+            // the queue and workers storage is first touched by a thread running on the node, allocating its pages there
+            std::thread allocationThread([&]()
+            {
+                SetCurrentThreadAffinity(nodeCores);
+                CreateQueue(newQueueIndex, threadCount, placement, name);
+            });
+            allocationThread.join();
+            return newQueueIndex;
+        }
+        LogWarning(fmt::format("NUMA node {} not found, queue {} workers are not placed", placement.numaNode, name));
     }
+    CreateQueue(newQueueIndex, threadCount, placement, name);
     return newQueueIndex;
 }
 
-void JobSystem::Begin()
+void JobSystem::CreateQueue(int queueIndex, int threadCount, const WorkerPlacement& placement, std::string_view name)
 {
-    for(auto& queue: queues_)
+    std::vector<int> queueCores;
+    switch (placement.policy)
+    {
+    case WorkerPlacement::Policy::NUMA_NODE:
+        queueCores = GetNumaNodeCores(placement.numaNode);
+        break;
+    case WorkerPlacement::Policy::AVOID_MAIN_THREAD_CORE:
+    {
+        if (mainThreadCore_ < 0)
+        {
+            mainThreadCore_ = GetCurrentCore();
+            if (mainThreadCore_ >= 0 && !SetCurrentThreadAffinity(std::span(&mainThreadCore_, 1)))
+            {
+                LogWarning("Could not pin the main thread to its core");
+            }
+        }
+        const auto coreCount = GetCoreCount();
+        for (int core = 0; core < coreCount; core++)
+        {
+            if (core != mainThreadCore_)
+            {
+                queueCores.push_back(core);
+            }
+        }
+        break;
+    }
+    default:
+        break;
+    }
+    queues_[queueIndex] = std::make_unique<WorkerQueue>();
+    queueCount_.store(queueIndex + 1, std::memory_order_release);
+    for(int i = 0; i < threadCount; i++)
     {
-        queue.Begin();
+        const int workerIndex = GetWorkerCount();
+        if (workerIndex >= MAX_WORKERS)
+        {
+            LogWarning(fmt::format("JobSystem cannot have more than {} workers, queue {} only has {} of its {} workers",
+                MAX_WORKERS, name, i, threadCount));
+            break;
+        }
+        auto workerCores = queueCores;
+        if (placement.policy == WorkerPlacement::Policy::PINNED_CORES && !placement.cores.empty())
+        {
+            workerCores = { placement.cores[i % placement.cores.size()] };
+        }
+        workers_[workerIndex] = std::make_unique<Worker>(*this, queueIndex, workerIndex,
+            fmt::format("{} {}", name, i), std::move(workerCores));
+        workerCount_.store(workerIndex + 1, std::memory_order_release);
+        queueWorkerCounts_[queueIndex].fetch_add(1, std::memory_order_release);
+        if (IsRunning())
+        {
+            workers_[workerIndex]->Begin();
+        }
     }
-    for(auto& worker : workers_)
+}
+
+void JobSystem::Begin()
+{
+    hasEnded_.store(false, std::memory_order_release);
+    isRunning_.store(true, std::memory_order_release);
+    const auto workerCount = GetWorkerCount();
+    for(int i = 0; i < workerCount; i++)
     {
-        worker.Begin();
+        workers_[i]->Begin();
     }
 }
 
 void JobSystem::AddJob(const std::shared_ptr<Job>& newJob, int queueIndex)
 {
     newJob->Reset();
+    newJob->keepAlive_ = newJob;
+    // a job without dependency is scheduled right away, End finds it in the queues
+    if (!newJob->dependencies_.empty())
+    {
+        TrackWaitingJob(newJob);
+    }
+    Submit(newJob.get(), queueIndex);
+}
+
+void JobSystem::TrackWaitingJob(const std::shared_ptr<Job>& job)
+{
+    static constexpr std::size_t MIN_WAITING_JOBS_PRUNE_SIZE = 64;
+    std::scoped_lock lock(waitingJobsMutex_);
+    if (waitingJobs_.size() >= waitingJobsPruneSize_)
+    {
+        // the jobs destroyed or started since they were tracked are not waiting anymore
+        std::erase_if(waitingJobs_, [](const std::weak_ptr<Job>& waitingJob)
+        {
+            const auto lockedJob = waitingJob.lock();
+            return lockedJob == nullptr || lockedJob->HasStarted();
+        });
+        waitingJobsPruneSize_ = std::max(MIN_WAITING_JOBS_PRUNE_SIZE, 2 * waitingJobs_.size());
+    }
+    waitingJobs_.push_back(job);
+}
+
+void JobSystem::AddJob(Job* newJob, int queueIndex)
+{
+    newJob->Reset();
+    Submit(newJob, queueIndex);
+}
+
+void JobSystem::Submit(Job* job, int queueIndex)
+{
+    job->jobSystem_ = this;
+    job->queueIndex_ = queueIndex;
+    if (queueIndex == MAIN_QUEUE_INDEX)
+    {
+        AddPendingMainJob(job);
+    }
+    for (const auto& dependency : job->dependencies_)
+    {
+        const auto lockedDependency = dependency.Lock();
+        if (lockedDependency == nullptr || !lockedDependency->AddSuccessor(job, dependency.type))
+        {
+            // dependency is already done, started or expired
+            job->pendingDependencies_.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    }
+    // releasing the submission count
+    if (job->pendingDependencies_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        Schedule(job);
+    }
+}
+
+void JobSystem::Schedule(Job* job)
+{
+    if (hasEnded_.load(std::memory_order_acquire))
+    {
+        // no worker is left to execute it, and End already emptied the queues
+        ReleaseUnexecutedJob(job);
+        return;
+    }
+    job->scheduleTime_ = std::chrono::steady_clock::now();
+    const auto queueIndex = job->queueIndex_;
     if(queueIndex == MAIN_QUEUE_INDEX)
     {
-        mainThreadQueue_.AddJob(newJob);
+        mainThreadQueue_.AddJob(job);
+        mainEpoch_.fetch_add(1, std::memory_order_seq_cst);
+        mainEpoch_.notify_one();
         return;
     }
-    queues_[queueIndex].AddJob(newJob);
+    if (job->GetPriority() != JobPriority::NORMAL || currentWorker == nullptr ||
+        currentWorker->GetQueueIndex() != queueIndex || !currentWorker->GetDeque().Push(job))
+    {
+        queues_[queueIndex]->AddJob(job);
+    }
+    WakeWorkers(queueIndex, job->GetPriority());
+}
+
+void JobSystem::WakeWorkers(int queueIndex, JobPriority priority)
+{
+    // only the epoch of the job queue changes on the hot path, a worker of that queue about to sleep looks for the job again
+    auto& queueWakeup = queueWakeups_[queueIndex];
+    queueWakeup.workEpoch.fetch_add(1, std::memory_order_seq_cst);
+    if (queueWakeup.sleepingWorkers.load(std::memory_order_seq_cst) > 0)
+    {
+        queueWakeup.workEpoch.notify_one();
+        return;
+    }
+    // background jobs are not stolen, the woken worker has to be one of their queue
+    if (priority == JobPriority::BACKGROUND)
+    {
+        return;
+    }
+    // no worker of the job queue sleeps, they may all be busy, so the workers of the other queues can steal it
+    const auto queueCount = GetQueueCount();
+    for (int i = 1; i < queueCount; i++)
+    {
+        queueWakeups_[(queueIndex + i) % queueCount].workEpoch.fetch_add(1, std::memory_order_seq_cst);
+    }
+    for (int i = 1; i < queueCount; i++)
+    {
+        auto& wakeup = queueWakeups_[(queueIndex + i) % queueCount];
+        if (wakeup.sleepingWorkers.load(std::memory_order_seq_cst) > 0)
+        {
+            wakeup.workEpoch.notify_one();
+            return;
+        }
+    }
+}
+
+void JobSystem::ExecuteJob(Job* job)
+{
+    auto& counters = GetCurrentCounters();
+    const auto start = std::chrono::steady_clock::now();
+    // the job can be destroyed as soon as it is executed
+    const auto latency = start - job->scheduleTime_;
+    executionDepth++;
+    job->Execute();
+    executionDepth--;
+    const auto duration = std::chrono::steady_clock::now() - start;
+    // nested executions are already counted in the busy time of the outer job
+    counters.AddJob(latency, executionDepth == 0 ? duration : std::chrono::nanoseconds::zero());
+}
+
+JobCounters& JobSystem::GetCurrentCounters()
+{
+    return currentWorker != nullptr ? currentWorker->GetCounters() : mainThreadCounters_;
+}
+
+JobSystemStats JobSystem::GetStats() const
+{
+    JobSystemStats stats;
+    stats.mainThread.name = "Main Thread";
+    mainThreadCounters_.FillStats(stats.mainThread);
+    const auto workerCount = GetWorkerCount();
+    stats.workers.resize(workerCount);
+    for (int i = 0; i < workerCount; i++)
+    {
+        auto& workerStats = stats.workers[i];
+        workerStats.name = workers_[i]->GetName();
+        workerStats.queueIndex = workers_[i]->GetQueueIndex();
+        workers_[i]->GetCounters().FillStats(workerStats);
+    }
+    stats.mainThreadQueue = mainThreadQueue_.GetStats();
+    const auto queueCount = GetQueueCount();
+    stats.queues.reserve(queueCount);
+    for (int i = 0; i < queueCount; i++)
+    {
+        stats.queues.push_back(queues_[i]->GetStats());
+    }
+    stats.successorLockContentions = successorLockContentions.load(std::memory_order_relaxed);
+    const auto allocations = GetJobAllocationCounters();
+    stats.allocations.heapAllocations = allocations.heapAllocations - allocationBaseline_.heapAllocations;
+    stats.allocations.poolAllocations = allocations.poolAllocations - allocationBaseline_.poolAllocations;
+    stats.allocations.poolOverflows = allocations.poolOverflows - allocationBaseline_.poolOverflows;
+    return stats;
+}
+
+void JobSystem::ResetStats()
+{
+    mainThreadCounters_.Reset();
+    const auto workerCount = GetWorkerCount();
+    for (int i = 0; i < workerCount; i++)
+    {
+        workers_[i]->GetCounters().Reset();
+    }
+    mainThreadQueue_.ResetStats();
+    const auto queueCount = GetQueueCount();
+    for (int i = 0; i < queueCount; i++)
+    {
+        queues_[i]->ResetStats();
+    }
+    plotSamples_ = {};
+    successorLockContentions.store(0, std::memory_order_relaxed);
+    allocationBaseline_ = GetJobAllocationCounters();
+}
+
+void JobSystem::PlotStats()
+{
+#ifdef TRACY_ENABLE
+    ZoneScoped;
+    auto plotBusyRatio = [this](const char* name, const JobCounters& counters, PlotSample& sample)
+    {
+        const auto busyNs = counters.GetBusyTime();
+        const auto idleNs = counters.GetIdleTime();
+        const auto busyDelta = busyNs - sample.busyNs;
+        const auto totalDelta = busyDelta + idleNs - sample.idleNs;
+        sample = { busyNs, idleNs };
+        if (totalDelta > 0)
+        {
+            TracyPlot(name, static_cast<double>(busyDelta) / static_cast<double>(totalDelta));
+        }
+    };
+    const auto workerCount = GetWorkerCount();
+    for (int i = 0; i < workerCount; i++)
+    {
+        plotBusyRatio(workers_[i]->GetName().c_str(), workers_[i]->GetCounters(), plotSamples_[i]);
+    }
+    plotBusyRatio("Main Thread", mainThreadCounters_, plotSamples_[MAX_WORKERS]);
+    auto plotDepth = [](const char* name, const QueueStats& queueStats)
+    {
+        std::size_t depth = 0;
+        for (const auto priorityDepth : queueStats.depth)
+        {
+            depth += priorityDepth;
+        }
+        TracyPlot(name, static_cast<std::int64_t>(depth));
+    };
+    plotDepth("Main Queue Depth", mainThreadQueue_.GetStats());
+    const auto queueCount = GetQueueCount();
+    for (int i = 0; i < queueCount; i++)
+    {
+        // plot names must keep the same address
+        auto& plotName = queuePlotNames_[i];
+        if (plotName.empty())
+        {
+            plotName = fmt::format("Queue {} Depth", i);
+        }
+        plotDepth(plotName.c_str(), queues_[i]->GetStats());
+    }
+#endif
+}
+
+int JobSystem::GetQueueWorkerCount(int queueIndex) const
+{
+    if (queueIndex < 0 || queueIndex >= GetQueueCount())
+    {
+        return 0;
+    }
+    return queueWorkerCounts_[queueIndex].load(std::memory_order_acquire);
+}
+
+void JobSystem::AddPendingMainJob(Job* job)
+{
+    if (job->GetPriority() == JobPriority::BACKGROUND)
+    {
+        // background main thread jobs are executed when there is time left, ExecuteMainThread does not wait for them
+        return;
+    }
+    job->isPendingMainJob_ = true;
+    pendingMainJobs_.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void JobSystem::ReleasePendingMainJob(Job* job)
+{
+    job->isPendingMainJob_ = false;
+    if (pendingMainJobs_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        // the last main thread job might have been done by a worker
+        mainEpoch_.fetch_add(1, std::memory_order_seq_cst);
+        mainEpoch_.notify_one();
+    }
+}
+
+bool JobSystem::TryExecuteWorkerJob(JobPriority lowestPriority)
+{
+    const auto queueCount = GetQueueCount();
+    for (int i = 0; i < queueCount; i++)
+    {
+        if (auto* job = queues_[i]->PopNextTask(lowestPriority); job != nullptr)
+        {
+            ExecuteJob(job);
+            return true;
+        }
+    }
+    const auto workerCount = GetWorkerCount();
+    for (int i = 0; i < workerCount; i++)
+    {
+        if (auto* job = workers_[i]->GetDeque().Steal(); job != nullptr)
+        {
+            GetCurrentCounters().AddSteal();
+            ExecuteJob(job);
+            return true;
+        }
+    }
+    return false;
 }
 
 void JobSystem::End()
 {
-    for(auto& queue: queues_)
+    if (!isRunning_.exchange(false, std::memory_order_acq_rel))
+    {
+        return;
+    }
+    for (auto& wakeup : queueWakeups_)
+    {
+        wakeup.workEpoch.fetch_add(1, std::memory_order_seq_cst);
+        wakeup.workEpoch.notify_all();
+    }
+    const auto workerCount = GetWorkerCount();
+    for(int i = 0; i < workerCount; i++)
+    {
+        workers_[i]->End();
+    }
+    // from now on, a released job schedules its successors to be released too, instead of queuing them
+    hasEnded_.store(true, std::memory_order_release);
+    // releasing the jobs that were never executed
+    for (int i = 0; i < workerCount; i++)
+    {
+        while (auto* job = workers_[i]->GetDeque().Pop())
+        {
+            ReleaseUnexecutedJob(job);
+        }
+    }
+    const auto queueCount = GetQueueCount();
+    for (int i = 0; i < queueCount; i++)
+    {
+        while (auto* job = queues_[i]->PopNextTask())
+        {
+            ReleaseUnexecutedJob(job);
+        }
+    }
+    while (auto* job = mainThreadQueue_.PopNextTask())
+    {
+        ReleaseUnexecutedJob(job);
+    }
+    // the shared jobs still waiting for their dependencies are in no queue, only their keepAlive_ holds them
+    std::vector<std::weak_ptr<Job>> waitingJobs;
     {
-        queue.End();
+        std::scoped_lock lock(waitingJobsMutex_);
+        waitingJobs = std::move(waitingJobs_);
+        waitingJobs_.clear();
+        waitingJobsPruneSize_ = 0;
     }
-    for(auto& worker: workers_)
+    for (const auto& waitingJob : waitingJobs)
     {
-        worker.End();
+        if (const auto job = waitingJob.lock(); job != nullptr && !job->HasStarted())
+        {
+            // a dependency outliving the JobSystem would release the discarded job when destroyed
+            job->DetachFromDependencies();
+            job->keepAlive_.reset();
+        }
+    }
+}
+
+void JobSystem::ReleaseUnexecutedJob(Job* job)
+{
+    if (job->pool_ != nullptr)
+    {
+        job->pool_->Release(job);
+        return;
     }
+    job->keepAlive_.reset();
 }
 
 void JobSystem::ExecuteMainThread()
 {
-    while (!mainThreadQueue_.IsEmpty())
+    while (pendingMainJobs_.load(std::memory_order_acquire) > 0)
     {
-        auto newTask = mainThreadQueue_.PopNextTask();
-        if (!newTask->ShouldStart())
+        const auto epoch = mainEpoch_.load(std::memory_order_acquire);
+        if (auto* newTask = mainThreadQueue_.PopNextTask(JobPriority::NORMAL); newTask != nullptr)
         {
-            mainThreadQueue_.AddJob(std::move(newTask));
+            ExecuteJob(newTask);
+            continue;
         }
-        else
+        if (TryExecuteWorkerJob(JobPriority::NORMAL))
         {
-            newTask->Execute();
+            continue;
         }
+        // waiting for a worker job to release a main thread job
+        const auto idleStart = std::chrono::steady_clock::now();
+        mainEpoch_.wait(epoch, std::memory_order_acquire);
+        mainThreadCounters_.AddIdle(std::chrono::steady_clock::now() - idleStart);
+    }
+    while (CanExecuteBackground())
+    {
+        auto* newTask = mainThreadQueue_.PopNextTask();
+        if (newTask == nullptr)
+        {
+            break;
+        }
+        ExecuteBackground(newTask);
     }
 }
 
+void JobSystem::SetFrameDeadline(std::chrono::steady_clock::time_point deadline)
+{
+    frameDeadline_ = deadline;
+    backgroundTime_ = std::chrono::steady_clock::duration::zero();
+}
+
+void JobSystem::SetBackgroundBudget(std::chrono::microseconds budget)
+{
+    backgroundBudget_ = budget;
+}
+
+bool JobSystem::CanExecuteBackground() const
+{
+    if (backgroundBudget_.count() > 0 && backgroundTime_ >= backgroundBudget_)
+    {
+        return false;
+    }
+    return std::chrono::steady_clock::now() < frameDeadline_;
+}
+
+void JobSystem::ExecuteBackground(Job* job)
+{
+    const auto start = std::chrono::steady_clock::now();
+    ExecuteJob(job);
+    backgroundTime_ += std::chrono::steady_clock::now() - start;
+}
+
 JobSystem* GetJobSystem()
 {
     return instance;
 }
-}
\ No newline at end of file
+}
@@ -0,0 +1,117 @@
+#include "utils/parallel.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+#ifdef TRACY_ENABLE
+#include <tracy/Tracy.hpp>
+#endif
+
+namespace core
+{
+
+namespace
+{
+/**
+ * @brief MAX_PARALLEL_FOR_HELPERS caps the helper jobs kept on the stack of each ParallelFor, which can be nested
+ */
+constexpr std::size_t MAX_PARALLEL_FOR_HELPERS = 16;
+
+struct ParallelForState
+{
+    std::size_t begin = 0;
+    std::size_t end = 0;
+    std::size_t grain = 1;
+    std::size_t chunkCount = 0;
+    std::atomic<std::size_t> nextChunk{ 0 };
+    void (*func)(void*, std::size_t, std::size_t) = nullptr;
+    void* context = nullptr;
+
+    void ExecuteChunks()
+    {
+        while (true)
+        {
+            const auto chunk = nextChunk.fetch_add(1, std::memory_order_relaxed);
+            if (chunk >= chunkCount)
+            {
+                return;
+            }
+            const auto chunkBegin = begin + chunk * grain;
+            const auto chunkEnd = std::min(end, chunkBegin + grain);
+            func(context, chunkBegin, chunkEnd);
+        }
+    }
+};
+
+class ParallelForJob final : public Job
+{
+public:
+    ParallelForState* state = nullptr;
+protected:
+    void ExecuteImpl() override
+    {
+#ifdef TRACY_ENABLE
+        ZoneScopedN("Parallel For");
+#endif
+        state->ExecuteChunks();
+    }
+};
+}
+
+void ParallelForChunks(std::size_t begin, std::size_t end, std::size_t grain,
+    void (*func)(void* context, std::size_t chunkBegin, std::size_t chunkEnd),
+    void* context, int queueIndex)
+{
+    if (end <= begin)
+    {
+        return;
+    }
+    grain = std::max<std::size_t>(grain, 1);
+    const auto chunkCount = (end - begin + grain - 1) / grain;
+    auto* jobSystem = GetJobSystem();
+    // the workers of the other queues, e.g. the file IO ones, are not counted as helpers
+    const int workerCount = jobSystem != nullptr && jobSystem->IsRunning() ?
+        jobSystem->GetQueueWorkerCount(queueIndex) : 0;
+    if (chunkCount == 1 || workerCount == 0)
+    {
+        func(context, begin, end);
+        return;
+    }
+
+    ParallelForState state;
+    state.begin = begin;
+    state.end = end;
+    state.grain = grain;
+    state.chunkCount = chunkCount;
+    state.func = func;
+    state.context = context;
+
+    // the calling thread takes chunks too, so it only needs chunkCount-1 helpers,
+    // only those are constructed, as each destructor takes the job successors lock
+    alignas(ParallelForJob) std::array<std::byte, MAX_PARALLEL_FOR_HELPERS * sizeof(ParallelForJob)> helperStorage;
+    auto* helperJobs = reinterpret_cast<ParallelForJob*>(helperStorage.data());
+    const auto helperCount = std::min({ chunkCount - 1, static_cast<std::size_t>(workerCount), MAX_PARALLEL_FOR_HELPERS });
+    for (std::size_t i = 0; i < helperCount; i++)
+    {
+        auto* helperJob = std::construct_at(helperJobs + i);
+        helperJob->state = &state;
+        jobSystem->AddJob(helperJob, queueIndex);
+    }
+    state.ExecuteChunks();
+    // the helpers reference the state on the stack, waiting for all of them while helping the workers
+    for (std::size_t i = 0; i < helperCount; i++)
+    {
+        while (!helperJobs[i].IsDone())
+        {
+            if (!jobSystem->TryExecuteWorkerJob(JobPriority::NORMAL))
+            {
+                std::this_thread::yield();
+            }
+        }
+        std::destroy_at(helperJobs + i);
+    }
+}
+
+} // namespace core
@@ -0,0 +1,138 @@
+#include "utils/thread_utils.h"
+
+#include <string>
+#include <thread>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <fstream>
+#include <sstream>
+#elif defined(__APPLE__)
+#include <pthread.h>
+#endif
+
+#ifdef TRACY_ENABLE
+#include <tracy/Tracy.hpp>
+#endif
+
+namespace core
+{
+
+void SetCurrentThreadName(std::string_view name)
+{
+    const std::string threadName(name);
+#if defined(_WIN32)
+    const std::wstring wideName(threadName.begin(), threadName.end());
+    SetThreadDescription(GetCurrentThread(), wideName.c_str());
+#elif defined(__linux__)
+    // linux thread names are limited to 15 characters
+    pthread_setname_np(pthread_self(), threadName.substr(0, 15).c_str());
+#elif defined(__APPLE__)
+    pthread_setname_np(threadName.c_str());
+#endif
+#ifdef TRACY_ENABLE
+    tracy::SetThreadName(threadName.c_str());
+#endif
+}
+
+bool SetCurrentThreadAffinity([[maybe_unused]] std::span<const int> cores)
+{
+    if (cores.empty())
+    {
+        return false;
+    }
+#if defined(_WIN32)
+    // only the first processor group is supported
+    DWORD_PTR mask = 0;
+    for (const auto core : cores)
+    {
+        if (core >= 0 && core < static_cast<int>(sizeof(DWORD_PTR) * 8))
+        {
+            mask |= static_cast<DWORD_PTR>(1) << core;
+        }
+    }
+    return mask != 0 && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#elif defined(__linux__)
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (const auto core : cores)
+    {
+        if (core >= 0 && core < CPU_SETSIZE)
+        {
+            CPU_SET(core, &cpuSet);
+        }
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0;
+#else
+    return false;
+#endif
+}
+
+std::vector<int> GetNumaNodeCores([[maybe_unused]] int numaNode)
+{
+    std::vector<int> cores;
+    if (numaNode < 0)
+    {
+        return cores;
+    }
+#if defined(_WIN32)
+    GROUP_AFFINITY affinity{};
+    if (GetNumaNodeProcessorMaskEx(static_cast<USHORT>(numaNode), &affinity) && affinity.Group == 0)
+    {
+        for (int core = 0; core < static_cast<int>(sizeof(KAFFINITY) * 8); core++)
+        {
+            if (affinity.Mask & (static_cast<KAFFINITY>(1) << core))
+            {
+                cores.push_back(core);
+            }
+        }
+    }
+#elif defined(__linux__)
+    // cpulist is formatted as ranges, e.g. "0-15,32-47"
+    std::ifstream cpuList("/sys/devices/system/node/node" + std::to_string(numaNode) + "/cpulist");
+    std::string range;
+    while (std::getline(cpuList, range, ','))
+    {
+        int first = 0;
+        int last = 0;
+        char separator = 0;
+        std::istringstream rangeStream(range);
+        if (!(rangeStream >> first))
+        {
+            continue;
+        }
+        last = first;
+        if (rangeStream >> separator && separator == '-')
+        {
+            rangeStream >> last;
+        }
+        for (int core = first; core <= last; core++)
+        {
+            cores.push_back(core);
+        }
+    }
+#endif
+    return cores;
+}
+
+int GetCurrentCore()
+{
+#if defined(_WIN32)
+    return static_cast<int>(GetCurrentProcessorNumber());
+#elif defined(__linux__)
+    return sched_getcpu();
+#else
+    return -1;
+#endif
+}
+
+int GetCoreCount()
+{
+    const auto coreCount = static_cast<int>(std::thread::hardware_concurrency());
+    return coreCount > 0 ? coreCount : 1;
+}
+
+} // namespace core
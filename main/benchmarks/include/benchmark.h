@@ -0,0 +1,35 @@
+#pragma once
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <string_view>
+
+namespace benchmark
+{
+
+/**
+ * @brief MeasureSeconds runs func the number of repetitions and returns its fastest run, in seconds
+ */
+template<typename Func>
+double MeasureSeconds(Func&& func, int repetitions = 5)
+{
+    double bestTime = std::numeric_limits<double>::max();
+    for (int i = 0; i < repetitions; i++)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        func();
+        const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+        bestTime = std::min(bestTime, duration.count());
+    }
+    return bestTime;
+}
+
+inline void PrintResult(std::string_view name, double seconds, double count, std::string_view unit)
+{
+    fmt::print("{:<40} {:>12.3f} ms {:>16.0f} {}/s\n", name, seconds * 1000.0, count / seconds, unit);
+}
+
+} // namespace benchmark
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "renderer/mesh.h"
+
+#include <glm/geometric.hpp>
+
+#include <cmath>
+#include <cstddef>
+
+namespace benchmark
+{
+
+/**
+ * @brief GenerateGridMesh generates a wavy grid of side * side vertices and 2 * (side - 1)^2 indexed triangles
+ */
+inline core::Mesh GenerateGridMesh(std::size_t side)
+{
+    core::Mesh mesh{};
+    mesh.name = "grid";
+    mesh.vertices.resize(side * side);
+    const auto step = 1.0f / static_cast<float>(side - 1);
+    for (std::size_t y = 0; y < side; y++)
+    {
+        for (std::size_t x = 0; x < side; x++)
+        {
+            const auto u = static_cast<float>(x) * step;
+            const auto v = static_cast<float>(y) * step;
+            auto& vertex = mesh.vertices[y * side + x];
+            vertex.position = { u, 0.05f * std::sin(20.0f * u) * std::cos(20.0f * v), v };
+            vertex.texCoords = { u, v };
+            vertex.normal = glm::normalize(glm::vec3(
+                -std::cos(20.0f * u) * std::cos(20.0f * v), 1.0f, std::sin(20.0f * u) * std::sin(20.0f * v)));
+        }
+    }
+    mesh.indices.reserve(6 * (side - 1) * (side - 1));
+    for (std::size_t y = 0; y + 1 < side; y++)
+    {
+        for (std::size_t x = 0; x + 1 < side; x++)
+        {
+            const auto vertex = static_cast<unsigned>(y * side + x);
+            const auto side32 = static_cast<unsigned>(side);
+            mesh.indices.insert(mesh.indices.end(), {
+                vertex, vertex + side32, vertex + 1,
+                vertex + 1, vertex + side32, vertex + side32 + 1 });
+        }
+    }
+    return mesh;
+}
+
+} // namespace benchmark
@@ -0,0 +1,150 @@
+#include "benchmark.h"
+
+#include "utils/job_pool.h"
+#include "utils/job_system.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <thread>
+
+namespace
+{
+std::atomic<std::uint64_t> globalAllocations{ 0 };
+}
+
+// every heap allocation of the process is counted, including the ones of std::make_shared and std::function
+void* operator new(std::size_t size)
+{
+    globalAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (auto* ptr = std::malloc(std::max<std::size_t>(size, 1)); ptr != nullptr)
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace
+{
+constexpr int FRAME_COUNT = 200;
+constexpr std::size_t FRAME_JOB_COUNT = 1024;
+constexpr int WORK_ITERATIONS = 64;
+constexpr int WORKER_COUNT = 4;
+
+struct FrameJobs
+{
+    std::atomic<std::size_t> doneCount{ 0 };
+
+    void Work()
+    {
+        volatile float value = 1.0f;
+        for (int i = 0; i < WORK_ITERATIONS; i++)
+        {
+            value = value * 1.0001f + 0.5f;
+        }
+        doneCount.fetch_add(1, std::memory_order_release);
+    }
+
+    void Wait(core::JobSystem& jobSystem, std::size_t jobCount)
+    {
+        while (doneCount.load(std::memory_order_acquire) < jobCount)
+        {
+            if (!jobSystem.TryExecuteWorkerJob(core::JobPriority::NORMAL))
+            {
+                std::this_thread::yield();
+            }
+        }
+        doneCount.store(0, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief RunFrames submits the jobs of each frame with submitFrame and waits for them,
+ * then prints the time and the allocations per frame
+ */
+template<typename SubmitFunc>
+void RunFrames(std::string_view name, core::JobSystem& jobSystem, int queueIndex, SubmitFunc&& submitFrame)
+{
+    FrameJobs frameJobs;
+    const auto startCounters = core::GetJobAllocationCounters();
+    const auto startAllocations = globalAllocations.load(std::memory_order_relaxed);
+    const auto time = benchmark::MeasureSeconds([&]
+    {
+        for (int frame = 0; frame < FRAME_COUNT; frame++)
+        {
+            submitFrame(frameJobs, queueIndex);
+            frameJobs.Wait(jobSystem, FRAME_JOB_COUNT);
+        }
+    }, 1);
+    const auto endCounters = core::GetJobAllocationCounters();
+    const auto endAllocations = globalAllocations.load(std::memory_order_relaxed);
+
+    benchmark::PrintResult(name, time, static_cast<double>(FRAME_COUNT * FRAME_JOB_COUNT), "jobs");
+    const auto perFrame = [](std::uint64_t start, std::uint64_t end)
+    {
+        return static_cast<double>(end - start) / FRAME_COUNT;
+    };
+    fmt::print("    per frame: {:.1f} allocations, {:.1f} job heap allocations, {:.1f} pool allocations, "
+        "{:.1f} pool overflows\n",
+        perFrame(startAllocations, endAllocations),
+        perFrame(startCounters.heapAllocations, endCounters.heapAllocations),
+        perFrame(startCounters.poolAllocations, endCounters.poolAllocations),
+        perFrame(startCounters.poolOverflows, endCounters.poolOverflows));
+}
+}
+
+int main()
+{
+    core::JobSystem jobSystem;
+    const auto queueIndex = jobSystem.SetupNewQueue(WORKER_COUNT);
+    jobSystem.Begin();
+    fmt::print("{} frames of {} jobs, {} workers\n", FRAME_COUNT, FRAME_JOB_COUNT, WORKER_COUNT);
+
+    RunFrames("shared FuncJob", jobSystem, queueIndex, [&jobSystem](FrameJobs& frameJobs, int queue)
+    {
+        for (std::size_t i = 0; i < FRAME_JOB_COUNT; i++)
+        {
+            jobSystem.AddJob(std::make_shared<core::FuncJob>([&frameJobs] { frameJobs.Work(); }), queue);
+        }
+    });
+
+    using FrameJob = core::InlineFuncJob<>;
+    // the jobs of a frame may still be released to the pool when the next frame starts, hence twice the frame size
+    core::JobPool<FrameJob> jobPool(2 * FRAME_JOB_COUNT);
+    RunFrames("pooled InlineFuncJob", jobSystem, queueIndex, [&jobSystem, &jobPool](FrameJobs& frameJobs, int queue)
+    {
+        for (std::size_t i = 0; i < FRAME_JOB_COUNT; i++)
+        {
+            jobSystem.AddJob(jobPool.Acquire([&frameJobs] { frameJobs.Work(); }), queue);
+        }
+    });
+
+    core::JobPool<FrameJob> smallJobPool(FRAME_JOB_COUNT / 4);
+    RunFrames("undersized pool InlineFuncJob", jobSystem, queueIndex,
+        [&jobSystem, &smallJobPool](FrameJobs& frameJobs, int queue)
+    {
+        for (std::size_t i = 0; i < FRAME_JOB_COUNT; i++)
+        {
+            jobSystem.AddJob(smallJobPool.Acquire([&frameJobs] { frameJobs.Work(); }), queue);
+        }
+    });
+
+    jobSystem.End();
+    return 0;
+}
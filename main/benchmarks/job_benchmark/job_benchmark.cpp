@@ -0,0 +1,219 @@
+#include "benchmark.h"
+
+#include "utils/job_system.h"
+
+#include <fmt/format.h>
+
+#include <array>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+constexpr std::size_t ROOT_JOB_COUNT = 1'000;
+constexpr std::size_t CHILD_JOB_COUNT = 100;
+constexpr std::size_t FLAT_JOB_COUNT = ROOT_JOB_COUNT * (CHILD_JOB_COUNT + 1);
+constexpr int WORK_ITERATIONS = 256;
+constexpr std::array THREAD_COUNTS = { 1, 2, 4, 8, 16, 32, 64 };
+
+/**
+ * @brief MutexJobQueue is the previous JobSystem queue: one std::queue behind a std::shared_mutex,
+ * a shared lock to check if it is empty then an exclusive lock to pop, and a condition variable to sleep.
+ */
+class MutexJobQueue
+{
+public:
+    explicit MutexJobQueue(int threadCount)
+    {
+        for (int i = 0; i < threadCount; i++)
+        {
+            threads_.emplace_back(&MutexJobQueue::Run, this);
+        }
+    }
+    ~MutexJobQueue()
+    {
+        Stop();
+    }
+    MutexJobQueue(const MutexJobQueue&) = delete;
+    MutexJobQueue& operator=(const MutexJobQueue&) = delete;
+
+    void AddJob(core::Job* job)
+    {
+        std::scoped_lock lock(mutex_);
+        jobs_.push(job);
+        conditionVariable_.notify_one();
+    }
+    /**
+     * @brief Stop joins the threads, so no job is executed once it returns
+     */
+    void Stop()
+    {
+        {
+            std::scoped_lock lock(mutex_);
+            isRunning_ = false;
+        }
+        conditionVariable_.notify_all();
+        for (auto& thread : threads_)
+        {
+            thread.join();
+        }
+        threads_.clear();
+    }
+private:
+    [[nodiscard]] bool IsEmpty() const
+    {
+        std::shared_lock lock(mutex_);
+        return jobs_.empty();
+    }
+    core::Job* PopNextTask()
+    {
+        if (IsEmpty())
+        {
+            return nullptr;
+        }
+        std::scoped_lock lock(mutex_);
+        if (jobs_.empty())
+        {
+            return nullptr;
+        }
+        auto* job = jobs_.front();
+        jobs_.pop();
+        return job;
+    }
+    void Run()
+    {
+        while (true)
+        {
+            if (auto* job = PopNextTask(); job != nullptr)
+            {
+                job->Execute();
+                continue;
+            }
+            std::unique_lock lock(mutex_);
+            conditionVariable_.wait(lock, [this] { return !isRunning_ || !jobs_.empty(); });
+            if (!isRunning_)
+            {
+                return;
+            }
+        }
+    }
+
+    mutable std::shared_mutex mutex_;
+    std::condition_variable_any conditionVariable_;
+    std::queue<core::Job*> jobs_;
+    std::vector<std::thread> threads_;
+    bool isRunning_ = true;
+};
+
+/**
+ * @brief JobSet holds the jobs of a scenario, they are reset and submitted again on each repetition.
+ * Root jobs submit their children from the thread executing them, like a loader spawning its decode jobs.
+ * A repetition waits for every job to be done, as a job is still accessed after its function returns.
+ */
+class JobSet
+{
+public:
+    using SubmitFunc = std::function<void(const std::shared_ptr<core::FuncJob>&)>;
+    JobSet(std::size_t rootCount, std::size_t childCount, SubmitFunc submit) :
+        submit_(std::move(submit))
+    {
+        children_.reserve(rootCount * childCount);
+        for (std::size_t i = 0; i < rootCount * childCount; i++)
+        {
+            children_.push_back(std::make_shared<core::FuncJob>([] { Work(); }));
+        }
+        roots_.reserve(rootCount);
+        for (std::size_t i = 0; i < rootCount; i++)
+        {
+            roots_.push_back(std::make_shared<core::FuncJob>([this, i, childCount]
+            {
+                for (std::size_t child = i * childCount; child < (i + 1) * childCount; child++)
+                {
+                    submit_(children_[child]);
+                }
+                Work();
+            }));
+        }
+    }
+
+    void Run(const std::function<void()>& wait)
+    {
+        for (auto& job : children_)
+        {
+            job->Reset();
+        }
+        for (auto& job : roots_)
+        {
+            job->Reset();
+            submit_(job);
+        }
+        Wait(roots_, wait);
+        Wait(children_, wait);
+    }
+private:
+    static void Wait(const std::vector<std::shared_ptr<core::FuncJob>>& jobs, const std::function<void()>& wait)
+    {
+        for (const auto& job : jobs)
+        {
+            while (!job->IsDone())
+            {
+                wait();
+            }
+        }
+    }
+    static void Work()
+    {
+        volatile float value = 1.0f;
+        for (int i = 0; i < WORK_ITERATIONS; i++)
+        {
+            value = value * 1.0001f + 0.5f;
+        }
+    }
+
+    SubmitFunc submit_;
+    std::vector<std::shared_ptr<core::FuncJob>> roots_;
+    std::vector<std::shared_ptr<core::FuncJob>> children_;
+};
+
+void RunScenario(std::string_view scenario, std::size_t rootCount, std::size_t childCount)
+{
+    fmt::print("{} jobs, {} roots with {} children each\n", rootCount * (childCount + 1), rootCount, childCount);
+    const auto jobCount = static_cast<double>(rootCount * (childCount + 1));
+    for (const auto threadCount : THREAD_COUNTS)
+    {
+        {
+            MutexJobQueue queue(threadCount);
+            JobSet jobSet(rootCount, childCount, [&queue](const std::shared_ptr<core::FuncJob>& job) { queue.AddJob(job.get()); });
+            const auto time = benchmark::MeasureSeconds([&jobSet] { jobSet.Run([] { std::this_thread::yield(); }); });
+            benchmark::PrintResult(fmt::format("{} mutex queue {} threads", scenario, threadCount), time, jobCount, "jobs");
+            // the threads are joined before the jobs are destroyed
+            queue.Stop();
+        }
+        {
+            core::JobSystem jobSystem;
+            const auto queueIndex = jobSystem.SetupNewQueue(threadCount);
+            jobSystem.Begin();
+            JobSet jobSet(rootCount, childCount, [&jobSystem, queueIndex](const std::shared_ptr<core::FuncJob>& job)
+            {
+                jobSystem.AddJob(job, queueIndex);
+            });
+            const auto time = benchmark::MeasureSeconds([&jobSet] { jobSet.Run([] { std::this_thread::yield(); }); });
+            benchmark::PrintResult(fmt::format("{} work-stealing {} threads", scenario, threadCount), time, jobCount, "jobs");
+            jobSystem.End();
+        }
+    }
+}
+}
+
+int main()
+{
+    RunScenario("flat", FLAT_JOB_COUNT, 0);
+    RunScenario("nested", ROOT_JOB_COUNT, CHILD_JOB_COUNT);
+    return 0;
+}
@@ -0,0 +1,176 @@
+#include "benchmark.h"
+
+#include "engine/filesystem.h"
+#include "renderer/model.h"
+#include "utils/job_system.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+// vertices per side of the generated grids, the biggest one has a million vertices and two million triangles
+constexpr std::array GRID_SIZES = { 256, 512, 1024 };
+constexpr int REPETITIONS = 3;
+// the model files of a scene, imported one after the other or all at once
+constexpr int SCENE_MODEL_COUNT = 8;
+constexpr int SCENE_GRID_SIZE = 256;
+
+/**
+ * @brief CreateObjGrid writes a displaced grid with texture coordinates and normals, as exported by a modeling tool
+ */
+void CreateObjGrid(const std::string& path, int gridSize)
+{
+    std::ofstream file(path);
+    file << "o grid\n";
+    const auto step = 1.0f / static_cast<float>(gridSize - 1);
+    for (int y = 0; y < gridSize; y++)
+    {
+        for (int x = 0; x < gridSize; x++)
+        {
+            const auto u = static_cast<float>(x) * step;
+            const auto v = static_cast<float>(y) * step;
+            file << fmt::format("v {:.6f} {:.6f} {:.6f}\nvt {:.6f} {:.6f}\nvn 0 1 0\n",
+                u - 0.5f, 0.1f * u * v, v - 0.5f, u, v);
+        }
+    }
+    for (int y = 0; y < gridSize - 1; y++)
+    {
+        for (int x = 0; x < gridSize - 1; x++)
+        {
+            // obj indices start at 1
+            const auto i0 = y * gridSize + x + 1;
+            const auto i1 = i0 + 1;
+            const auto i2 = i0 + gridSize;
+            const auto i3 = i2 + 1;
+            file << fmt::format("f {0}/{0}/{0} {1}/{1}/{1} {2}/{2}/{2}\nf {1}/{1}/{1} {3}/{3}/{3} {2}/{2}/{2}\n",
+                i0, i2, i1, i3);
+        }
+    }
+}
+
+std::size_t CountVertices(const core::Model& model)
+{
+    std::size_t vertexCount = 0;
+    for (const auto& mesh : model.GetMeshes())
+    {
+        vertexCount += mesh.vertices.size();
+    }
+    return vertexCount;
+}
+
+void RunImport(const fs::path& rootDirectory, int gridSize)
+{
+    const auto objPath = (rootDirectory / fmt::format("grid{}.obj", gridSize)).generic_string();
+    const auto binaryModelPath = (rootDirectory / fmt::format("grid{}{}", gridSize, core::MODEL_FILE_EXTENSION)).generic_string();
+    CreateObjGrid(objPath, gridSize);
+
+    core::ModelManager modelManager;
+    std::size_t vertexCount = 0;
+    const auto objTime = benchmark::MeasureSeconds([&]
+    {
+        modelManager.Clear();
+        const auto modelIndex = modelManager.ImportModel(core::Path(objPath));
+        vertexCount = modelIndex == core::INVALID_MODEL_INDEX ? 0 : CountVertices(modelManager.GetModel(modelIndex));
+    }, REPETITIONS);
+    if (vertexCount == 0)
+    {
+        fmt::print(stderr, "Could not import: {}\n", objPath);
+        return;
+    }
+    benchmark::PrintResult(fmt::format("assimp obj {}x{}", gridSize, gridSize), objTime,
+        static_cast<double>(vertexCount), "vertices");
+
+    {
+        const auto serializedModel = modelManager.GetModel(modelManager.ImportModel(core::Path(objPath))).Serialize();
+        std::ofstream file(binaryModelPath, std::ios::binary);
+        file.write(serializedModel.data(), static_cast<std::streamsize>(serializedModel.size()));
+    }
+    std::size_t binaryVertexCount = 0;
+    const auto binaryTime = benchmark::MeasureSeconds([&]
+    {
+        modelManager.Clear();
+        const auto modelIndex = modelManager.ImportModel(core::Path(binaryModelPath));
+        binaryVertexCount = modelIndex == core::INVALID_MODEL_INDEX ? 0 : CountVertices(modelManager.GetModel(modelIndex));
+    }, REPETITIONS);
+    if (binaryVertexCount != vertexCount)
+    {
+        fmt::print(stderr, "Binary model has {} vertices instead of {}\n", binaryVertexCount, vertexCount);
+    }
+    benchmark::PrintResult(fmt::format("binary model {}x{}", gridSize, gridSize), binaryTime,
+        static_cast<double>(vertexCount), "vertices");
+    fmt::print("{:<40} {:>12.1f}x\n", "binary model speedup", objTime / binaryTime);
+}
+
+void RunSceneImport(const fs::path& rootDirectory)
+{
+    std::vector<core::Path> modelPaths;
+    for (int i = 0; i < SCENE_MODEL_COUNT; i++)
+    {
+        const auto objPath = (rootDirectory / fmt::format("scene{}.obj", i)).generic_string();
+        CreateObjGrid(objPath, SCENE_GRID_SIZE);
+        modelPaths.emplace_back(objPath);
+    }
+
+    core::ModelManager modelManager;
+    const auto serialTime = benchmark::MeasureSeconds([&]
+    {
+        modelManager.Clear();
+        for (const auto& modelPath : modelPaths)
+        {
+            modelManager.ImportModel(modelPath);
+        }
+    }, REPETITIONS);
+    benchmark::PrintResult(fmt::format("import {} obj one by one", SCENE_MODEL_COUNT), serialTime,
+        static_cast<double>(SCENE_MODEL_COUNT), "models");
+    const auto batchTime = benchmark::MeasureSeconds([&]
+    {
+        modelManager.Clear();
+        const auto modelIndices = modelManager.ImportModels(modelPaths);
+        if (std::ranges::find(modelIndices, core::INVALID_MODEL_INDEX) != modelIndices.end())
+        {
+            fmt::print(stderr, "Could not import the scene models\n");
+        }
+    }, REPETITIONS);
+    benchmark::PrintResult(fmt::format("import {} obj at once", SCENE_MODEL_COUNT), batchTime,
+        static_cast<double>(SCENE_MODEL_COUNT), "models");
+}
+}
+
+int main()
+{
+    core::DefaultFilesystem filesystem;
+    core::FilesystemLocator::provide(&filesystem);
+    // the worker queue of the engine, the vertices of the imported meshes are converted on it
+    core::JobSystem jobSystem;
+    const auto threadCount = static_cast<int>(std::thread::hardware_concurrency());
+    if (threadCount > 1)
+    {
+        jobSystem.SetupNewQueue(threadCount - 1);
+    }
+    jobSystem.Begin();
+
+    // relative to the working directory, as the model paths must fit in Path::MAX_PATH_LENGTH
+    const fs::path rootDirectory = "model_benchmark";
+    fs::remove_all(rootDirectory);
+    fs::create_directories(rootDirectory);
+    for (const auto gridSize : GRID_SIZES)
+    {
+        RunImport(rootDirectory, gridSize);
+    }
+    RunSceneImport(rootDirectory);
+    fs::remove_all(rootDirectory);
+
+    jobSystem.End();
+    core::FilesystemLocator::provide(nullptr);
+    return 0;
+}
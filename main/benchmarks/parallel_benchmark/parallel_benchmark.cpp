@@ -0,0 +1,136 @@
+#include "benchmark.h"
+#include "benchmark_mesh.h"
+
+#include "renderer/mesh_streams.h"
+#include "utils/job_system.h"
+#include "utils/parallel.h"
+
+#include <fmt/format.h>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+constexpr std::size_t GRID_SIDE = 2048;
+constexpr std::size_t VERTEX_GRAIN = 16 * 1024;
+constexpr std::size_t SORT_GRAIN = 64 * 1024;
+
+struct Bounds
+{
+    glm::vec3 min;
+    glm::vec3 max;
+};
+
+std::vector<int> GetThreadCounts()
+{
+    const int maxThreadCount = std::clamp(static_cast<int>(std::thread::hardware_concurrency()), 1,
+        core::JobSystem::MAX_WORKERS);
+    std::vector<int> threadCounts;
+    for (int threadCount = 1; threadCount < maxThreadCount; threadCount *= 2)
+    {
+        threadCounts.push_back(threadCount);
+    }
+    threadCounts.push_back(maxThreadCount);
+    return threadCounts;
+}
+
+/**
+ * @brief RunWorkloads measures the mesh processing kernels, the calling thread takes part in the parallel loops
+ */
+void RunWorkloads(const core::Mesh& mesh, int threadCount)
+{
+    const auto vertexCount = mesh.vertices.size();
+    const auto triangleCount = mesh.indices.size() / 3;
+
+    std::vector<glm::vec3> positions(vertexCount);
+    std::vector<glm::vec3> normals(vertexCount);
+    const auto transformTime = benchmark::MeasureSeconds([&]
+    {
+        core::ParallelForRange(0, vertexCount, VERTEX_GRAIN, [&](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; i++)
+            {
+                positions[i] = mesh.vertices[i].position * glm::vec3(2.0f, 0.5f, 2.0f) + glm::vec3(1.0f);
+                normals[i] = glm::normalize(mesh.vertices[i].normal * glm::vec3(0.5f, 2.0f, 0.5f));
+            }
+        });
+    });
+    benchmark::PrintResult(fmt::format("transform vertices {} threads", threadCount),
+        transformTime, static_cast<double>(vertexCount), "vertices");
+
+    Bounds bounds{};
+    const auto boundsTime = benchmark::MeasureSeconds([&]
+    {
+        const auto& firstPosition = mesh.vertices.front().position;
+        bounds = core::ParallelReduce(0, vertexCount, VERTEX_GRAIN, Bounds{ firstPosition, firstPosition },
+            [&mesh](std::size_t i) { return Bounds{ mesh.vertices[i].position, mesh.vertices[i].position }; },
+            [](const Bounds& a, const Bounds& b)
+            {
+                return Bounds{ glm::min(a.min, b.min), glm::max(a.max, b.max) };
+            });
+    });
+    benchmark::PrintResult(fmt::format("reduce bounds {} threads", threadCount),
+        boundsTime, static_cast<double>(vertexCount), "vertices");
+
+    // the same bounds from the position stream only, instead of the 56 bytes vertices
+    const auto streams = core::SplitMesh(mesh);
+    core::MeshBounds streamBounds{};
+    const auto streamBoundsTime = benchmark::MeasureSeconds([&]
+    {
+        streamBounds = core::ComputeBounds(streams.positions);
+    });
+    benchmark::PrintResult(fmt::format("stream bounds {} threads", threadCount),
+        streamBoundsTime, static_cast<double>(vertexCount), "vertices");
+    if (streamBounds.min != bounds.min || streamBounds.max != bounds.max)
+    {
+        fmt::print(stderr, "Stream bounds differ from the vertex bounds with {} threads\n", threadCount);
+    }
+
+    // triangles sorted by depth, the keys are copied back in each run so every run sorts the same data
+    std::vector<std::pair<float, std::uint32_t>> triangleDepths(triangleCount);
+    core::ParallelFor(0, triangleCount, VERTEX_GRAIN, [&](std::size_t triangle)
+    {
+        const auto* indices = mesh.indices.data() + 3 * triangle;
+        const auto depth = mesh.vertices[indices[0]].position.y + mesh.vertices[indices[1]].position.y +
+            mesh.vertices[indices[2]].position.y;
+        triangleDepths[triangle] = { depth, static_cast<std::uint32_t>(triangle) };
+    });
+    auto sortedDepths = triangleDepths;
+    const auto sortTime = benchmark::MeasureSeconds([&]
+    {
+        std::ranges::copy(triangleDepths, sortedDepths.begin());
+        core::ParallelSort(sortedDepths.begin(), sortedDepths.end(), SORT_GRAIN);
+    });
+    benchmark::PrintResult(fmt::format("sort triangles {} threads", threadCount),
+        sortTime, static_cast<double>(triangleCount), "triangles");
+    if (!std::ranges::is_sorted(sortedDepths))
+    {
+        fmt::print(stderr, "ParallelSort did not sort the triangles with {} threads\n", threadCount);
+    }
+}
+}
+
+int main()
+{
+    const auto mesh = benchmark::GenerateGridMesh(GRID_SIDE);
+    fmt::print("{} vertices, {} triangles\n", mesh.vertices.size(), mesh.indices.size() / 3);
+    for (const auto threadCount : GetThreadCounts())
+    {
+        core::JobSystem jobSystem;
+        // the calling thread executes chunks too, it is one of the threads
+        if (threadCount > 1)
+        {
+            jobSystem.SetupNewQueue(threadCount - 1);
+        }
+        jobSystem.Begin();
+        RunWorkloads(mesh, threadCount);
+        jobSystem.End();
+    }
+    return 0;
+}
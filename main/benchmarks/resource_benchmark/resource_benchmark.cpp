@@ -0,0 +1,140 @@
+#include "benchmark.h"
+
+#include "engine/filesystem.h"
+#include "engine/resource.h"
+#include "utils/job_system.h"
+
+#include <fmt/format.h>
+
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+constexpr std::array RESOURCE_COUNTS = { std::size_t{ 1'000 }, std::size_t{ 10'000 } };
+constexpr int IO_THREAD_COUNT = 2;
+
+std::vector<std::string> CreateResourceFiles(const fs::path& directory, std::size_t count)
+{
+    fs::create_directories(directory);
+    std::vector<std::string> paths;
+    paths.reserve(count);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        auto path = (directory / fmt::format("{}.txt", i)).generic_string();
+        std::ofstream file(path, std::ios::binary);
+        file << i;
+        paths.push_back(std::move(path));
+    }
+    return paths;
+}
+
+/**
+ * @brief RegisterResources registers every path, the handles are kept so the resources stay referenced
+ */
+double RegisterResources(core::ResourceManager& resourceManager, const std::vector<std::string>& paths,
+    std::vector<core::ResourceHandle>& handles)
+{
+    return benchmark::MeasureSeconds([&]
+    {
+        for (const auto& path : paths)
+        {
+            handles.push_back(resourceManager.AddResource(path));
+        }
+    }, 1);
+}
+
+/**
+ * @brief WaitForLoads updates the ResourceManager until every registered resource has moved its file buffer
+ */
+void WaitForLoads(core::ResourceManager& resourceManager, const std::vector<core::ResourceHandle>& handles)
+{
+    for (const auto& handle : handles)
+    {
+        while (handle.IsValid() && !handle.HasLoaded())
+        {
+            resourceManager.Update(0.0f);
+            std::this_thread::yield();
+        }
+    }
+}
+
+void RunRegistration(const fs::path& rootDirectory, std::size_t count)
+{
+    const auto directory = rootDirectory / fmt::format("r{}", count);
+    const auto paths = CreateResourceFiles(directory, count);
+    // the same files through a linked directory, only their file identity matches the registered resources
+    std::vector<std::string> linkedPaths;
+    const auto linkDirectory = rootDirectory / fmt::format("l{}", count);
+    std::error_code error;
+    fs::create_directory_symlink(fs::absolute(directory), linkDirectory, error);
+    if (!error)
+    {
+        linkedPaths.reserve(count);
+        for (std::size_t i = 0; i < count; i++)
+        {
+            linkedPaths.push_back((linkDirectory / fmt::format("{}.txt", i)).generic_string());
+        }
+    }
+
+    core::ResourceManager resourceManager;
+    resourceManager.Begin();
+    std::vector<core::ResourceHandle> handles;
+    handles.reserve(3 * count);
+
+    const auto newTime = RegisterResources(resourceManager, paths, handles);
+    benchmark::PrintResult(fmt::format("register {} new resources", count), newTime,
+        static_cast<double>(count), "resources");
+    const auto existingTime = RegisterResources(resourceManager, paths, handles);
+    benchmark::PrintResult(fmt::format("register {} existing paths", count), existingTime,
+        static_cast<double>(count), "resources");
+    if (!linkedPaths.empty())
+    {
+        const auto linkedTime = RegisterResources(resourceManager, linkedPaths, handles);
+        benchmark::PrintResult(fmt::format("register {} linked paths", count), linkedTime,
+            static_cast<double>(count), "resources");
+    }
+    else
+    {
+        fmt::print("could not create a directory link, linked paths are not measured: {}\n", error.message());
+    }
+    if (handles[2 * count - 1].GetId() != handles[count - 1].GetId() ||
+        (!linkedPaths.empty() && handles.back().GetId() != handles[count - 1].GetId()))
+    {
+        fmt::print(stderr, "Registered paths to the same file were not deduplicated\n");
+    }
+
+    WaitForLoads(resourceManager, handles);
+    handles.clear();
+    resourceManager.End();
+}
+}
+
+int main()
+{
+    core::DefaultFilesystem filesystem;
+    core::FilesystemLocator::provide(&filesystem);
+    core::JobSystem jobSystem;
+    filesystem.SetIoQueue(jobSystem.SetupNewQueue(IO_THREAD_COUNT, {}, "File IO"));
+    jobSystem.Begin();
+
+    // relative to the working directory, as the resource paths must fit in Path::MAX_PATH_LENGTH
+    const fs::path rootDirectory = "resource_benchmark";
+    fs::remove_all(rootDirectory);
+    for (const auto count : RESOURCE_COUNTS)
+    {
+        RunRegistration(rootDirectory, count);
+    }
+    fs::remove_all(rootDirectory);
+
+    jobSystem.End();
+    core::FilesystemLocator::provide(nullptr);
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include "benchmark.h"
+#include "benchmark_mesh.h"
+
+#include "renderer/mesh_streams.h"
+#include "renderer/mesh_tangents.h"
+#include "utils/job_system.h"
+
+#include <fmt/format.h>
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace
+{
+// 2 * 708^2, a bit more than a million triangles
+constexpr std::size_t GRID_SIDE = 709;
+constexpr float MAX_TANGENT_ERROR = 1.0e-3f;
+
+std::vector<int> GetThreadCounts()
+{
+    const int maxThreadCount = std::clamp(static_cast<int>(std::thread::hardware_concurrency()), 1,
+        core::JobSystem::MAX_WORKERS);
+    std::vector<int> threadCounts;
+    for (int threadCount = 1; threadCount < maxThreadCount; threadCount *= 2)
+    {
+        threadCounts.push_back(threadCount);
+    }
+    threadCounts.push_back(maxThreadCount);
+    return threadCounts;
+}
+
+/**
+ * @brief GenerateScalarTangents is the per triangle loop the generated meshes used before,
+ * accumulated and normalized so its result can be compared
+ */
+void GenerateScalarTangents(core::Mesh& mesh)
+{
+    for (auto& vertex : mesh.vertices)
+    {
+        vertex.tangent = glm::vec3(0.0f);
+        vertex.bitangent = glm::vec3(0.0f);
+    }
+    for (std::size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+    {
+        auto& v0 = mesh.vertices[mesh.indices[i]];
+        auto& v1 = mesh.vertices[mesh.indices[i + 1]];
+        auto& v2 = mesh.vertices[mesh.indices[i + 2]];
+        const glm::vec3 edge1 = v1.position - v0.position;
+        const glm::vec3 edge2 = v2.position - v0.position;
+        const glm::vec2 deltaUV1 = v1.texCoords - v0.texCoords;
+        const glm::vec2 deltaUV2 = v2.texCoords - v0.texCoords;
+        const float f = 1.0f / (deltaUV1.x * deltaUV2.y - deltaUV2.x * deltaUV1.y);
+        const auto tangent = f * (deltaUV2.y * edge1 - deltaUV1.y * edge2);
+        const auto bitangent = f * (deltaUV1.x * edge2 - deltaUV2.x * edge1);
+        for (auto* vertex : { &v0, &v1, &v2 })
+        {
+            vertex->tangent += tangent;
+            vertex->bitangent += bitangent;
+        }
+    }
+    for (auto& vertex : mesh.vertices)
+    {
+        vertex.tangent = glm::normalize(vertex.tangent - vertex.normal * glm::dot(vertex.normal, vertex.tangent));
+        vertex.bitangent = glm::normalize(vertex.bitangent);
+    }
+}
+
+/**
+ * @brief CheckTangents returns whether the tangent frames are orthonormal and follow the uv directions of the grid
+ */
+bool CheckTangents(const core::MeshStreams& streams)
+{
+    for (std::size_t i = 0; i < streams.GetVertexCount(); i++)
+    {
+        const auto& normal = streams.normals[i];
+        const auto& tangent = streams.tangents[i];
+        const auto& bitangent = streams.bitangents[i];
+        if (std::abs(glm::length(tangent) - 1.0f) > MAX_TANGENT_ERROR ||
+            std::abs(glm::dot(tangent, normal)) > MAX_TANGENT_ERROR ||
+            std::abs(glm::dot(bitangent, tangent)) > MAX_TANGENT_ERROR ||
+            tangent.x <= 0.0f || bitangent.z <= 0.0f)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+}
+
+int main()
+{
+    const auto mesh = benchmark::GenerateGridMesh(GRID_SIDE);
+    const auto triangleCount = static_cast<double>(mesh.indices.size() / 3);
+    fmt::print("{} vertices, {} triangles\n", mesh.vertices.size(), mesh.indices.size() / 3);
+
+    auto scalarMesh = mesh;
+    const auto scalarTime = benchmark::MeasureSeconds([&scalarMesh] { GenerateScalarTangents(scalarMesh); });
+    benchmark::PrintResult("scalar tangents", scalarTime, triangleCount, "triangles");
+
+    auto streams = core::SplitMesh(mesh);
+    for (const auto threadCount : GetThreadCounts())
+    {
+        core::JobSystem jobSystem;
+        // the calling thread executes chunks too, it is one of the threads
+        if (threadCount > 1)
+        {
+            jobSystem.SetupNewQueue(threadCount - 1);
+        }
+        jobSystem.Begin();
+        const auto time = benchmark::MeasureSeconds([&streams] { core::GenerateTangents(streams); });
+        jobSystem.End();
+        benchmark::PrintResult(fmt::format("GenerateTangents {} threads", threadCount), time, triangleCount, "triangles");
+        if (!CheckTangents(streams))
+        {
+            fmt::print(stderr, "GenerateTangents gave invalid tangents with {} threads\n", threadCount);
+        }
+    }
+    return 0;
+}
@@ -25,6 +25,7 @@ public:
     void Begin() override;
     void Update(float dt) override;
     void End() override;
+    [[nodiscard]] core::SystemAccess GetAccess() const override;
     void OnEvent(SDL_Event &event) override;
     void AddResource(const Resource &resource) override;
     void RemoveResource(const Resource &resource) override;
@@ -43,6 +44,8 @@ private:
     void DrawCenterView();
     void DrawInspector();
     static void DrawLogWindow();
+    void DrawJobSystemWindow();
+    void DrawAssetCacheWindow();
     void UpdateFileDialog();
     void LoadFileIntoEditor(const core::Path &path);
     void RecursiveSceneFileReload();
@@ -60,6 +63,8 @@ private:
     std::string newCreateFilename_;
     std::string newCreateExtension_;
     int currentExtensionCreateFileIndex_ = 0;
+    bool showJobSystemWindow_ = false;
+    bool showAssetCacheWindow_ = false;
 
     inline static Editor* instance_ = nullptr;
 };
@@ -13,6 +13,7 @@ public:
     void Begin() override;
     void Update(float dt) override;
     void End() override;
+    [[nodiscard]] core::SystemAccess GetAccess() const override;
     void OnGui() override;
     void OnEvent(SDL_Event& event) override;
     void SetScene(std::string_view path);
@@ -14,7 +14,8 @@ int main([[maybe_unused]] int argc, char** argv)
 
 
     core::EnableLogRecording();
-    core::DefaultFilesystem filesystem;
+    // the editor replaces the files it writes, so the big ones can be memory mapped
+    core::DefaultFilesystem filesystem(true);
     core::FilesystemLocator::provide(&filesystem);
     gl::Engine engine;
     int major = 0, minor = 0;
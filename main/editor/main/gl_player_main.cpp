@@ -1,5 +1,5 @@
 #include "player.h"
-#include "phys_filesystem.h"
+#include "engine/pack.h"
 #include "py_interface.h"
 #include "gl/engine.h"
 
@@ -8,9 +8,8 @@
 
 int main([[maybe_unused]] int argc, [[maybe_unused]] char** argv)
 {
-    core::PhysFilesystem physFilesystem(argv[0]);
-    physFilesystem.Begin();
-    core::FilesystemLocator::provide(&physFilesystem);
+    core::PackFilesystem packFilesystem;
+    core::FilesystemLocator::provide(&packFilesystem);
 
     argh::parser cmdl(argv);
 
@@ -32,6 +31,5 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char** argv)
     engine.RegisterSystem(&player);
     engine.RegisterEventObserver(&player);
     engine.Run();
-    physFilesystem.End();
     return EXIT_SUCCESS;
 }
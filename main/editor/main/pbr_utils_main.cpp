@@ -16,6 +16,7 @@ public:
     void Begin() override;
     void Update(float dt) override;
     void End() override;
+    [[nodiscard]] core::SystemAccess GetAccess() const override;
 private:
     std::string hdrFile_;
 };
@@ -33,6 +34,12 @@ void PbrUtilSystem::End()
 {
 }
 
+core::SystemAccess PbrUtilSystem::GetAccess() const
+{
+    // the maps are generated in Begin, Update touches nothing
+    return { core::SystemResource::NONE, core::SystemResource::NONE, false };
+}
+
 int main(int argc, char** argv)
 {
     argh::parser cmdl(argv);
@@ -1,7 +1,7 @@
 
 #include <argh.h>
 
-#include "phys_filesystem.h"
+#include "engine/pack.h"
 #include "player.h"
 #include "py_interface.h"
 #include "engine/script.h"
@@ -9,9 +9,8 @@
 
 int main([[maybe_unused]]int argc, char** argv)
 {
-    core::PhysFilesystem physFilesystem(argv[0]);
-    physFilesystem.Begin();
-    core::FilesystemLocator::provide(&physFilesystem);
+    core::PackFilesystem packFilesystem;
+    core::FilesystemLocator::provide(&packFilesystem);
 
     argh::parser cmdl(argv);
     vk::Engine engine;
@@ -40,7 +39,6 @@ int main([[maybe_unused]]int argc, char** argv)
     engine.RegisterEventObserver(&player);
 
     engine.Run();
-    physFilesystem.End();
 
     return EXIT_SUCCESS;
 }
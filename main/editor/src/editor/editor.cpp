@@ -6,6 +6,7 @@
 #include <SDL.h>
 #include <pybind11/embed.h>
 #include <fmt/format.h>
+#include "engine/engine.h"
 #include "engine/filesystem.h"
 #include "editor_filesystem.h"
 #include "py_interface.h"
@@ -86,6 +87,8 @@ void Editor::OnGui()
     ImGui::SetNextWindowPos(ImVec2(0, windowSize.y * 0.6f), ImGuiCond_FirstUseEver);
     ImGui::SetNextWindowSize(ImVec2(windowSize.x, windowSize.y * 0.4f), ImGuiCond_FirstUseEver);
     DrawLogWindow();
+    DrawJobSystemWindow();
+    DrawAssetCacheWindow();
 
     UpdateFileDialog();
 }
@@ -100,6 +103,12 @@ void Editor::End()
     ImNodes::DestroyContext();
 }
 
+core::SystemAccess Editor::GetAccess() const
+{
+    // the editor works in OnGui, its Update touches nothing
+    return { core::SystemResource::NONE, core::SystemResource::NONE, false };
+}
+
 
 void Editor::OpenMenuCreateNewFile(EditorType editorType, std::string_view extension)
 {
@@ -154,6 +163,8 @@ void Editor::DrawMenuBar()
         if (ImGui::BeginMenu("Window"))
         {
             //TODO put editor list
+            ImGui::MenuItem("Job System", nullptr, &showJobSystemWindow_);
+            ImGui::MenuItem("Asset Cache", nullptr, &showAssetCacheWindow_);
             ImGui::EndMenu();
         }
         ImGui::EndMainMenuBar();
@@ -486,6 +497,110 @@ void Editor::DrawLogWindow()
     ImGui::End();
 
 }
+
+void Editor::DrawJobSystemWindow()
+{
+    if (!showJobSystemWindow_)
+    {
+        return;
+    }
+    auto* jobSystem = core::GetJobSystem();
+    if (!ImGui::Begin("Job System", &showJobSystemWindow_))
+    {
+        ImGui::End();
+        return;
+    }
+    const auto stats = jobSystem->GetStats();
+    if (ImGui::Button("Reset"))
+    {
+        jobSystem->ResetStats();
+    }
+    if (ImGui::BeginTable("Workers", 8, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+    {
+        ImGui::TableSetupColumn("Thread");
+        ImGui::TableSetupColumn("Queue");
+        ImGui::TableSetupColumn("Jobs");
+        ImGui::TableSetupColumn("Steals");
+        ImGui::TableSetupColumn("Busy");
+        ImGui::TableSetupColumn("Avg (us)");
+        ImGui::TableSetupColumn("P95 (us)");
+        ImGui::TableSetupColumn("P99 (us)");
+        ImGui::TableHeadersRow();
+        auto drawWorker = [](const core::WorkerStats& worker)
+        {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(worker.name.c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%d", worker.queueIndex);
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(worker.jobsExecuted));
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(worker.steals));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f%%", worker.busyRatio * 100.0f);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", worker.averageLatencyUs);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", worker.p95LatencyUs);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", worker.p99LatencyUs);
+        };
+        drawWorker(stats.mainThread);
+        for (const auto& worker : stats.workers)
+        {
+            drawWorker(worker);
+        }
+        ImGui::EndTable();
+    }
+    auto drawQueue = [](std::string_view name, const core::QueueStats& queue)
+    {
+        ImGui::Text("%.*s: %llu enqueued, depth critical %zu frame %zu normal %zu background %zu, %llu overflows",
+            static_cast<int>(name.size()), name.data(),
+            static_cast<unsigned long long>(queue.jobsEnqueued),
+            queue.depth[0], queue.depth[1], queue.depth[2], queue.depth[3],
+            static_cast<unsigned long long>(queue.overflowPushes));
+    };
+    drawQueue("Main Queue", stats.mainThreadQueue);
+    for (std::size_t i = 0; i < stats.queues.size(); i++)
+    {
+        drawQueue(fmt::format("Queue {}", i), stats.queues[i]);
+    }
+    ImGui::Text("Successor lock contentions: %llu", static_cast<unsigned long long>(stats.successorLockContentions));
+    ImGui::Text("Job allocations: %llu heap, %llu pooled, %llu pool overflows",
+        static_cast<unsigned long long>(stats.allocations.heapAllocations),
+        static_cast<unsigned long long>(stats.allocations.poolAllocations),
+        static_cast<unsigned long long>(stats.allocations.poolOverflows));
+    ImGui::End();
+}
+
+void Editor::DrawAssetCacheWindow()
+{
+    if (!showAssetCacheWindow_)
+    {
+        return;
+    }
+    auto& assetCache = core::GetAssetCache();
+    if (!ImGui::Begin("Asset Cache", &showAssetCacheWindow_))
+    {
+        ImGui::End();
+        return;
+    }
+    const auto stats = assetCache.GetStats();
+    if (ImGui::Button("Reset"))
+    {
+        assetCache.ResetStats();
+    }
+    const auto lookups = stats.hits + stats.misses;
+    ImGui::Text("Hits: %llu, misses: %llu, hit ratio: %.1f%%",
+        static_cast<unsigned long long>(stats.hits), static_cast<unsigned long long>(stats.misses),
+        lookups == 0 ? 0.0f : 100.0f * static_cast<float>(stats.hits) / static_cast<float>(lookups));
+    ImGui::Text("Stores: %llu, evictions: %llu",
+        static_cast<unsigned long long>(stats.stores), static_cast<unsigned long long>(stats.evictions));
+    ImGui::Text("Entries: %zu, size: %.1f / %.1f MB", stats.entryCount,
+        static_cast<double>(stats.size) / (1024.0 * 1024.0), static_cast<double>(stats.maxSize) / (1024.0 * 1024.0));
+    ImGui::End();
+}
 void Editor::OnEvent(SDL_Event& event)
 {
     switch (event.type)
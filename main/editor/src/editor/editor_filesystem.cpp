@@ -27,7 +27,15 @@ bool CopyFileFromTo(const core::Path &srcPath, const core::Path &dstPath, bool f
 {
     try
     {
-        fs::copy(srcPath.c_str(), dstPath.c_str(), forceOverwrite?fs::copy_options::overwrite_existing:fs::copy_options::skip_existing);
+        if (!forceOverwrite || !fs::exists(dstPath.c_str()))
+        {
+            fs::copy(srcPath.c_str(), dstPath.c_str(), fs::copy_options::skip_existing);
+            return true;
+        }
+        // the file is replaced instead of rewritten in place, as the engine may have it memory mapped
+        const auto tmpPath = fmt::format("{}.tmp", dstPath.c_str());
+        fs::copy(srcPath.c_str(), tmpPath, fs::copy_options::overwrite_existing);
+        fs::rename(tmpPath, dstPath.c_str());
     }
     catch (fs::filesystem_error& e)
     {
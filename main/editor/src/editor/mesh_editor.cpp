@@ -24,6 +24,25 @@ void MeshEditor::DrawInspector()
 
     auto& currentMesh = meshInfos_[currentIndex_];
 
+    static constexpr std::array<std::string_view, 3> vertexLayoutNames =
+    {
+        "Full (56 bytes)",
+        "Compact (32 bytes)",
+        "Quantized (20 bytes)"
+    };
+    const int vertexLayoutIndex = currentMesh.info.mesh().vertex_layout();
+    if(ImGui::BeginCombo("Vertex Layout", vertexLayoutNames[vertexLayoutIndex].data()))
+    {
+        for(std::size_t i = 0; i < vertexLayoutNames.size(); i++)
+        {
+            if(ImGui::Selectable(vertexLayoutNames[i].data(), i == vertexLayoutIndex))
+            {
+                currentMesh.info.mutable_mesh()->set_vertex_layout(static_cast<core::pb::VertexLayout>(i));
+            }
+        }
+        ImGui::EndCombo();
+    }
+
     if(currentMesh.info.mesh().primitve_type() == core::pb::Mesh_PrimitveType_MODEL)
     {
         const auto modelName = GetFilename(currentMesh.info.model_path());
@@ -369,6 +369,8 @@ void ModelEditor::ImportResource(const core::Path &path)
         }
     }
     core::Path modelDstPath {fmt::format("{}{}", dstFolder, GetFilename(path))};
+    //the binary model is what the player loads, the obj is only kept as the source of the import
+    core::Path binaryModelDstPath {fmt::format("{}{}{}", dstFolder, GetFilename(path, false), core::MODEL_FILE_EXTENSION)};
 
     auto meshes = model.GetMeshes();
     for (auto& shape : meshes)
@@ -384,7 +386,7 @@ void ModelEditor::ImportResource(const core::Path &path)
         auto* meshEditor = dynamic_cast<MeshEditor*>(editor->GetEditorSystem(EditorType::MESH));
         auto* meshInfo = meshEditor->GetMesh(meshInfoId);
         meshInfo->info.mutable_mesh()->set_primitve_type(core::pb::Mesh_PrimitveType_MODEL);
-        meshInfo->info.set_model_path(modelDstPath.c_str());
+        meshInfo->info.set_model_path(binaryModelDstPath.c_str());
         meshInfo->info.mutable_mesh()->set_mesh_name(shape.name);
         auto* newMesh = newModel.add_meshes();
         newMesh->set_mesh_name(shape.name);
@@ -407,7 +409,11 @@ void ModelEditor::ImportResource(const core::Path &path)
     resourceManager.AddResource(modelDstPath);
     sceneEditor->AddResource(*resourceManager.GetResource(resourceManager.FindResourceByPath(modelDstPath)));
 
-    newModel.set_model_path(modelDstPath.c_str());
+    filesystem.WriteString(binaryModelDstPath, model.Serialize());
+    resourceManager.AddResource(binaryModelDstPath);
+    sceneEditor->AddResource(*resourceManager.GetResource(resourceManager.FindResourceByPath(binaryModelDstPath)));
+
+    newModel.set_model_path(binaryModelDstPath.c_str());
 
     core::Path modelInfoPath {fmt::format("{}{}.model", dstFolder, GetFilename(path, false))};
     filesystem.WriteString(modelInfoPath, newModel.SerializeAsString());
@@ -142,6 +142,24 @@ void PipelineEditor::DrawInspector()
             ImGui::EndCombo();
         }
         ImGui::Separator();
+        static constexpr std::array<std::string_view, 3> vertexLayoutNames =
+        {
+            "FULL_VERTEX",
+            "COMPACT_VERTEX",
+            "QUANTIZED_VERTEX"
+        };
+        const int vertexLayoutIndex = currentPipelineInfo.info.pipeline().vertex_layout();
+        if(ImGui::BeginCombo("Vertex Layout", vertexLayoutNames[vertexLayoutIndex].data()))
+        {
+            for (std::size_t i = 0; i < vertexLayoutNames.size(); i++)
+            {
+                if (ImGui::Selectable(vertexLayoutNames[i].data(), i == vertexLayoutIndex))
+                {
+                    currentPipelineInfo.info.mutable_pipeline()->set_vertex_layout(static_cast<core::pb::VertexLayout>(i));
+                }
+            }
+            ImGui::EndCombo();
+        }
         bool depthTesting = currentPipelineInfo.info.pipeline().depth_test_enable();
 
         if(ImGui::Checkbox("Depth Testing", &depthTesting))
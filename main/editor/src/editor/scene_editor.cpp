@@ -1,5 +1,6 @@
 #include "scene_editor.h"
 #include "engine/filesystem.h"
+#include "engine/pack.h"
 #include "utils/log.h"
 #include "render_pass_editor.h"
 #include "command_editor.h"
@@ -10,10 +11,6 @@
 
 #include "editor.h"
 
-
-#include <pybind11/pybind11.h>
-#include <nlohmann/json.hpp>
-
 #include "buffer_editor.h"
 #include "material_editor.h"
 #include "mesh_editor.h"
@@ -25,9 +22,6 @@
 #include "framebuffer_editor.h"
 #include "gl/engine.h"
 
-namespace py = pybind11;
-using json = nlohmann::json;
-
 namespace editor
 {
 
@@ -848,76 +842,57 @@ bool SceneEditor::ExportAndPlayScene() const
             *exportScene.add_systems() = pySystemInfo->info;
         }
     }
-    constexpr core::Path exportScenePath = "root.scene";
-    //Write scene
-    std::ofstream fileOut(exportScenePath.c_str(), std::ios::binary);
-    if (!exportScene.SerializeToOstream(&fileOut))
+    constexpr std::string_view exportScenePath = "root.scene";
+    core::PackWriter packWriter;
+    std::string sceneData;
+    if (!exportScene.SerializeToString(&sceneData))
     {
         LogWarning(fmt::format("Could not save scene for export at: {}", exportScenePath));
         return false;
     }
-    fileOut.close(); //force write
-    //Create scene json
-    json sceneJson;
-    sceneJson["scene"] = exportScenePath.c_str();
-    std::vector<std::string> shaderPaths;
-    shaderPaths.reserve(exportScene.shaders_size());
+    packWriter.AddData(exportScenePath, std::move(sceneData));
     for(int i = 0; i < exportScene.shaders_size(); i++)
     {
-        shaderPaths.push_back(fs::path(exportScene.shaders(i).path(), std::filesystem::path::generic_format).string());
+        packWriter.AddFile(exportScene.shaders(i).path());
     }
-    sceneJson["shaders"] = shaderPaths;
-    std::vector<std::string> scriptPaths;
-    scriptPaths.reserve(exportScene.systems_size());
     for (int i = 0; i < exportScene.systems_size(); i++)
     {
         if(exportScene.systems(i).path().empty())
             continue;
-        scriptPaths.push_back(fs::path(exportScene.systems(i).path(), std::filesystem::path::generic_format).string());
+        packWriter.AddFile(exportScene.systems(i).path());
     }
-    sceneJson["scripts"] = scriptPaths;
-    std::vector<std::string> texturePaths;
-    texturePaths.reserve(exportScene.textures_size());
+    //textures are already compressed, keeping them stored allows to use them in place
     for(int i = 0; i < exportScene.textures_size(); i++)
     {
-        texturePaths.push_back(exportScene.textures(i).path());
+        packWriter.AddFile(exportScene.textures(i).path(), {}, core::PackCompression::STORED);
     }
-    sceneJson["textures"] = texturePaths;
-    sceneJson["cubemap_textures"] = cubemapTextures;
-    std::vector<std::string> objPaths;
-    objPaths.reserve(exportScene.model_paths_size());
-    for(int i = 0; i < exportScene.model_paths_size(); i++)
+    for (const auto& cubemapTexture : cubemapTextures)
     {
-        objPaths.push_back(exportScene.model_paths(i));
+        packWriter.AddFile(cubemapTexture, {}, core::PackCompression::STORED);
     }
-    sceneJson["models"] = objPaths;
-
-    std::vector<std::string> others;
-    for(auto& objFile : objPaths)
+    for(int i = 0; i < exportScene.model_paths_size(); i++)
     {
+        const auto& objFile = exportScene.model_paths(i);
+        //binary models are loaded in place by the player, they do not need their material files
+        if (GetFileExtension(core::Path(objFile)) == core::MODEL_FILE_EXTENSION)
+        {
+            packWriter.AddFile(objFile, {}, core::PackCompression::STORED);
+            continue;
+        }
+        packWriter.AddFile(objFile);
         const core::Path modelPath{
             fmt::format("{}/{}.model", GetFolder(core::Path(objFile)), GetFilename(objFile, false))};
         const auto modelId = resourceManager.FindResourceByPath(modelPath);
         auto* model = modelEditor->GetModel(modelId);
-        for(int i = 0; i < model->info.mtl_paths_size(); i++)
+        for(int j = 0; j < model->info.mtl_paths_size(); j++)
         {
-            others.push_back(model->info.mtl_paths(i));
+            packWriter.AddFile(model->info.mtl_paths(j));
         }
     }
-    sceneJson["others"] = others;
-
-    //Call python function exporting the scene
-    try
-    {
-        py::function exportSceneFunc = py::module_::import("scripts.generate_scene").attr("export_scene");
-        exportSceneFunc(pkgSceneName, sceneJson.dump());
-    }
-    catch (py::error_already_set& e)
+    if (!packWriter.Write(pkgSceneName))
     {
-        LogError(e.what());
         return false;
     }
-    RemoveFile(exportScenePath);
     ExecutePlayer(pkgSceneName);
     return true;
 }
@@ -1,5 +1,5 @@
 #include "player.h"
-#include "phys_filesystem.h"
+#include "engine/pack.h"
 
 #include <filesystem>
 #include <imgui.h>
@@ -55,6 +55,12 @@ void Player::End()
     sceneManager_.End();
 }
 
+core::SystemAccess Player::GetAccess() const
+{
+    // Update only forwards to the scene manager
+    return sceneManager_.GetAccess();
+}
+
 void Player::OnGui()
 {
     if(sceneLoaded_)
@@ -66,8 +72,11 @@ void Player::OnGui()
         {
             if (ImGui::Selectable(scene.c_str()))
             {
-                auto& filesystem = dynamic_cast<core::PhysFilesystem&>(core::FilesystemLocator::get());
-                filesystem.AddMount(scene, "", 1);
+                auto& filesystem = dynamic_cast<core::PackFilesystem&>(core::FilesystemLocator::get());
+                if (!filesystem.Mount(scene))
+                {
+                    continue;
+                }
                 core::pb::Scene newScene;
                 const auto file = filesystem.LoadFile("root.scene");
                 newScene.ParseFromArray(file.data, file.size);
@@ -88,8 +97,11 @@ void Player::OnEvent(SDL_Event& event)
 
 void Player::SetScene(std::string_view path)
 {
-    auto& filesystem = dynamic_cast<core::PhysFilesystem&>(core::FilesystemLocator::get());
-    filesystem.AddMount(path, "", 1);
+    auto& filesystem = dynamic_cast<core::PackFilesystem&>(core::FilesystemLocator::get());
+    if (!filesystem.Mount(path))
+    {
+        return;
+    }
     core::pb::Scene newScene;
     const auto file = filesystem.LoadFile("root.scene");
     newScene.ParseFromArray(file.data, file.size);
@@ -1,6 +1,6 @@
 #include "player.h"
 
-#include "phys_filesystem.h"
+#include "engine/pack.h"
 #include "engine/filesystem.h"
 
 namespace vk
@@ -21,6 +21,12 @@ void Player::End()
     sceneManager_.End();
 }
 
+core::SystemAccess Player::GetAccess() const
+{
+    // Update only forwards to the scene manager
+    return sceneManager_.GetAccess();
+}
+
 void Player::OnGui()
 {
 }
@@ -32,8 +38,11 @@ void Player::OnEvent(SDL_Event& event)
 
 void Player::SetScene(std::string_view path)
 {
-    auto& filesystem = dynamic_cast<core::PhysFilesystem&>(core::FilesystemLocator::get());
-    filesystem.AddMount(path, "", 1);
+    auto& filesystem = dynamic_cast<core::PackFilesystem&>(core::FilesystemLocator::get());
+    if (!filesystem.Mount(path))
+    {
+        return;
+    }
     core::pb::Scene newScene;
     const auto file = filesystem.LoadFile("root.scene");
     newScene.ParseFromArray(file.data, file.size);
@@ -9,8 +9,17 @@ uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 
+// QUANTIZED_VERTEX positions are in the mesh bounds, the other layouts get the identity
+struct PositionQuantization
+{
+    vec3 scale;
+    vec3 offset;
+};
+uniform PositionQuantization positionQuantization;
+
 void main()
 {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    vec3 position = aPos * positionQuantization.scale + positionQuantization.offset;
+    gl_Position = projection * view * model * vec4(position, 1.0);
     TexCoord = aTexCoord;
 }
\ No newline at end of file
@@ -11,7 +11,8 @@
 int main([[maybe_unused]]int argc, char** argv)
 {
     argh::parser cmdl(argv);
-    core::DefaultFilesystem filesystem;
+    // the samples never write the files they load, so the big ones can be memory mapped
+    core::DefaultFilesystem filesystem(true);
     core::FilesystemLocator::provide(&filesystem);
     gl::Engine engine;
     int major = 0, minor = 0;
@@ -759,6 +759,12 @@ void SampleBrowserProgram::End()
 {
     sceneManager_.End();
 }
+
+core::SystemAccess SampleBrowserProgram::GetAccess() const
+{
+    // Update only forwards to the scene manager
+    return sceneManager_.GetAccess();
+}
 void SampleBrowserProgram::OnGui()
 {
     ImGui::Begin("Sample Browser");
@@ -13,8 +13,16 @@ layout(binding = 0) uniform uniforms
     uniform mat4 projection;
 } ubo;
 
+// QUANTIZED_VERTEX positions are in the mesh bounds, the other layouts get the identity
+layout(push_constant) uniform PositionQuantization
+{
+    vec3 scale;
+    vec3 offset;
+} positionQuantization;
+
 void main()
 {
-    gl_Position = ubo.projection * ubo.view * ubo.model * vec4(aPos, 1.0);
+    vec3 position = aPos * positionQuantization.scale + positionQuantization.offset;
+    gl_Position = ubo.projection * ubo.view * ubo.model * vec4(position, 1.0);
     TexCoord = aTexCoord;
 }
\ No newline at end of file
@@ -798,6 +798,12 @@ void HelloVulkanProgram::End()
 {
     sceneManager_.End();
 }
+
+core::SystemAccess HelloVulkanProgram::GetAccess() const
+{
+    // Update only forwards to the scene manager
+    return sceneManager_.GetAccess();
+}
 void HelloVulkanProgram::OnGui()
 {
 }